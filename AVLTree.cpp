@@ -2,8 +2,14 @@
 // Created by Michał Nowaliński on 20-Dec-18.
 //
 
+#ifndef LAB_AVLTREE_CPP
+#define LAB_AVLTREE_CPP
+
 #include<iostream>
 #include <iomanip>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
@@ -16,7 +22,7 @@ using namespace std;
  * every two subtrees whose root is same node have heights different at the most by 1. It
  * is achieved via adding operation of balancing after adding or removing a node.
  * @tparam t1 type of key in nodes, it needs to have overwritten operators: >, <, =, ==, !=
- * @tparam t2 type of value in nodes, it needs to have overwritten operators: >, <, =, ==, !=
+ * @tparam t2 type of value in nodes, it needs to have overwritten operators: =, ==
  */
 template<typename t1, typename t2>
 class AVLTree {
@@ -59,13 +65,32 @@ class AVLTree {
      * Clears tree
      * @param node root of tree
      */
-    void makeEmpty(Node *node) {
+    static void makeEmpty(Node *node) {
         if (node == NULL) return;
         makeEmpty(node->left);
         makeEmpty(node->right);
         delete node;
     }
 
+    /**
+     * Copies subtree node by node, so the copy has the same shape
+     * @param node root of subtree to be copied
+     * @param parent parent of the copy
+     * @return root of the copy
+     */
+    static Node *clone(const Node *node, Node *parent) {
+        if (node == nullptr) return nullptr;
+        Node *copy = new Node{node->key, node->value, parent, nullptr, nullptr, node->height};
+        try {
+            copy->left = clone(node->left, copy);
+            copy->right = clone(node->right, copy);
+        } catch (...) {
+            makeEmpty(copy);
+            throw;
+        }
+        return copy;
+    }
+
     /**
      * Creates new node with given key and value
      * @param key key of new node
@@ -87,24 +112,29 @@ class AVLTree {
       * @param key key to be looked for
       * @return node with given key
       */
-    Node *findKey(Node *node, t1 key) {
-        if (node == nullptr) return nullptr;
-        else if (node->key == key) return node;
-        else if (key > node->key) return findKey(node->right, key);
-        return findKey(node->left, key);
+    Node *findKey(Node *node, const t1 &key) {
+        while (node != nullptr && node->key != key) node = key > node->key ? node->right : node->left;
+        return node;
     }
 
     /**
-     * Looks for node with given value
-     * @param node node from which recursive searching is performed
+     * Looks for node with given value. Tree is ordered by keys, not values, so every node of the subtree
+     * may have to be visited, O(n). Values are compared only with ==.
+     * @param node node from which searching is performed
      * @param value value to be looked for
-     * @return node with given value
-     */
-    Node *findValue(Node *node, t2 value) {
-        if (node == nullptr) return nullptr;
-        else if (node->value == value) return node;
-        else if (value > node->value) return findValue(node->right, value);
-        return findValue(node->left, value);
+     * @return node with given value, nullptr if there is none
+     */
+    Node *findValue(Node *node, const t2 &value) {
+        vector<Node *> pending;
+        if (node != nullptr) pending.push_back(node);
+        while (!pending.empty()) {
+            node = pending.back();
+            pending.pop_back();
+            if (node->value == value) return node;
+            if (node->right != nullptr) pending.push_back(node->right);
+            if (node->left != nullptr) pending.push_back(node->left);
+        }
+        return nullptr;
     }
 
 
@@ -181,7 +211,7 @@ class AVLTree {
 
 
         node->height = max(height(node->left), height(node->right)) + 1;
-        tmp->height = max(height(node->right), node->height) + 1;
+        tmp->height = max(height(tmp->right), node->height) + 1;
         return tmp;
     }
 
@@ -237,30 +267,35 @@ class AVLTree {
         Node *temp;
 
         if (node == NULL) return NULL;
-        else if (key < node->key) node->left = remove(key, value, node->left);
-        else if (key > node->key) node->right = remove(key, value, node->right);
-
-        else if (node->left && node->right) {
+        else if (key < node->key) {
+            node->left = remove(key, value, node->left);
+            if (node->left) node->left->parent = node;
+        } else if (key > node->key) {
+            node->right = remove(key, value, node->right);
+            if (node->right) node->right->parent = node;
+        } else if (node->left && node->right) {
             temp = findMin(node->right);
             node->key = temp->key;
             node->value = temp->value;
             node->right = remove(node->key, node->value, node->right);
+            if (node->right) node->right->parent = node;
         } else {
             temp = node;
             if (node->left == NULL) node = node->right;
             else if (node->right == NULL) node = node->left;
+            if (node) node->parent = temp->parent;
             delete temp;
         }
         if (node == NULL) return node;
 
         node->height = max(height(node->left), height(node->right)) + 1;
 
-        if (height(node->left) - height(node->right) == 2) {
-            if (height(node->left->left) - height(node->left->right) == 1) return singleLeftRotate(node);
-            else return doubleLeftRotate(node);
-        } else if (height(node->right) - height(node->left) == 2) {
-            if (height(node->right->right) - height(node->right->left) == 1) return singleRightRotate(node);
+        if (getBalance(node) == 2) {
+            if (getBalance(node->left) >= 0) return singleRightRotate(node);
             else return doubleRightRotate(node);
+        } else if (getBalance(node) == -2) {
+            if (getBalance(node->right) <= 0) return singleLeftRotate(node);
+            else return doubleLeftRotate(node);
         }
         return node;
     }
@@ -301,6 +336,11 @@ class AVLTree {
     }
 
 public:
+    /**
+     * Pointer to a node of the tree, as returned by searchKey and searchValue
+     */
+    typedef Node *Handle;
+
     template<typename K, typename I>
     class Iterator {
         Node *it;
@@ -370,10 +410,7 @@ public:
             Node *p;
 
             if (it == nullptr) {
-                if (it == nullptr) return nullptr;
-                while (it->left != nullptr) {
-                    it = it->left;
-                }
+                return *this;
             } else if (it->right != nullptr) {
                 it = it->right;
 
@@ -399,7 +436,7 @@ public:
             if (!it) return *this;
             else {
                 Node *p;
-                auto *temporary = new Iterator(it);
+                Iterator temporary(it);
                 if (it == nullptr) {
                     while (it->left != nullptr) {
                         it = it->left;
@@ -418,7 +455,7 @@ public:
                     }
                     it = p;
                 }
-                return *temporary;
+                return temporary;
             }
         }
 
@@ -430,10 +467,7 @@ public:
             Node *p;
 
             if (it == nullptr) {
-                if (it == nullptr) return nullptr;
-                while (it->right != nullptr) {
-                    it = it->right;
-                }
+                return *this;
             } else if (it->left != nullptr) {
                 it = it->left;
 
@@ -459,7 +493,7 @@ public:
             if (!it) return *this;
             else {
                 Node *p;
-                auto *temporary = new Iterator(it);
+                Iterator temporary(it);
                 if (it == nullptr) {
                     while (it->right != nullptr) {
                         it = it->right;
@@ -478,7 +512,7 @@ public:
                     }
                     it = p;
                 }
-                return *temporary;
+                return temporary;
             }
         }
 
@@ -563,6 +597,23 @@ public:
      */
     TreeIterator last() { return root ? TreeIterator(findMax(root)) : TreeIterator(nullptr); }
 
+    /**
+     * Looks for the first node, in order of keys, whose key is not less than given key. Costs O(log n)
+     * @param key key
+     * @return iterator to that node, end() if every key is less than given key
+     */
+    TreeIterator lowerBound(const t1 &key) {
+        Node *node = root, *found = nullptr;
+        while (node != nullptr) {
+            if (node->key < key) node = node->right;
+            else {
+                found = node;
+                node = node->left;
+            }
+        }
+        return TreeIterator(found);
+    }
+
     /**
      * Searches for iterator with given value
      * @param value value
@@ -611,14 +662,26 @@ public:
     }
 
     /**
-     * COpying contrcutor
+     * Copying constructor, copies nodes of the tree in O(n)
      * @param tree tree based on which new tree shall be created
      */
-    AVLTree(AVLTree &tree) {
+    AVLTree(const AVLTree &tree) {
+        root = clone(tree.root, nullptr);
+    }
+
+    /**
+     * Destructor
+     */
+    ~AVLTree() {
+        makeEmpty(root);
+    }
+
+    /**
+     * Removes all nodes
+     */
+    void clear() {
+        makeEmpty(root);
         root = NULL;
-        for (TreeIterator it = tree.begin(); it != tree.end(); it++){
-            insert(it->key, it->value);
-        }
     }
 
     /**
@@ -627,6 +690,7 @@ public:
      */
     void insert(t1 x, t2 y) {
         root = insert(x, y, root);
+        root->parent = nullptr;
     }
 
     /**
@@ -634,8 +698,10 @@ public:
      * @param x data with which node shall be removed
      */
     void remove(t1 x) {
-        t2 y = searchKey(x)->value;
-        root = remove(x, y, root);
+        Node *node = searchKey(x);
+        if (node == nullptr) return;
+        root = remove(x, node->value, root);
+        if (root) root->parent = nullptr;
     }
 
     /**
@@ -643,16 +709,71 @@ public:
      * @param key key which a Node shall have
      * @return Node that has such key
      */
-    Node *searchKey(t1 key) {
+    Node *searchKey(const t1 &key) {
         return findKey(root, key);
     }
 
     /**
-     * Looks for Node with given value
+     * Looks for Nodes with given keys. Instead of descending the tree key after key, up to BATCH_GROUP
+     * descents are kept in flight and advanced one level each in turn. Child node of every descent is
+     * prefetched when it is chosen and is read only after all other descents moved, so cache misses
+     * of the whole group overlap instead of being paid one after another.
+     * @param keys keys to be looked for
+     * @param count number of keys
+     * @param out array of count handles, out[i] is Node with keys[i] or nullptr if there is no such key
+     */
+    void findBatch(const t1 *keys, size_t count, Handle *out) {
+        const size_t BATCH_GROUP = 16;
+        Node *cursor[BATCH_GROUP];
+        size_t index[BATCH_GROUP];
+        size_t active = 0, next = 0;
+        for (; active < BATCH_GROUP && next < count; active++, next++) {
+            cursor[active] = root;
+            index[active] = next;
+        }
+        while (active > 0) {
+            for (size_t slot = 0; slot < active;) {
+                Node *node = cursor[slot];
+                const t1 &key = keys[index[slot]];
+                if (node == nullptr || node->key == key) {
+                    out[index[slot]] = node;
+                    if (next < count) {
+                        cursor[slot] = root;
+                        index[slot] = next++;
+                        slot++;
+                    } else {
+                        active--;
+                        cursor[slot] = cursor[active];
+                        index[slot] = index[active];
+                    }
+                    continue;
+                }
+                node = key > node->key ? node->right : node->left;
+#if defined(__GNUC__)
+                __builtin_prefetch(node);
+#endif
+                cursor[slot] = node;
+                slot++;
+            }
+        }
+    }
+
+    /**
+     * Looks for Nodes with given keys, see findBatch(const t1 *, size_t, Handle *)
+     * @param keys keys to be looked for
+     * @param out handles of found Nodes, resized to number of keys, nullptr for missing keys
+     */
+    void findBatch(const vector<t1> &keys, vector<Handle> &out) {
+        out.resize(keys.size());
+        findBatch(keys.data(), keys.size(), out.data());
+    }
+
+    /**
+     * Looks for Node with given value, visiting nodes in pre-order until it is found. O(n)
      * @param value value which a Node shall have
      * @return Node that has such value
      */
-    Node *searchValue(t2 value) {
+    Node *searchValue(const t2 &value) {
         return findValue(root, value);
     }
 
@@ -683,11 +804,11 @@ public:
      * @return key of given element
      */
     t1 operator()(t2 value) {
-        if (searchValue(value) == nullptr) {
+        Node *found = searchValue(value);
+        if (found == nullptr) {
             throw std::invalid_argument("Tree does not have such key");
         }
-        t1 key = searchValue(value)->key;
-        return key;
+        return found->key;
     }
 
     /**
@@ -702,7 +823,7 @@ public:
         for (TreeIterator itTree = tree1.begin(); itTree != tree1.end(); itTree++) {
             if (it == nullptr && itTree == nullptr) return true;
             if (it == nullptr || itTree == nullptr) return false;
-            if (it->key != itTree->key && it->value != itTree->value) return false;
+            if (it->key != itTree->key || it->value != itTree->value) return false;
             it++;
         }
         return true;
@@ -710,13 +831,17 @@ public:
 
 
     /**
-     * Overwritten operator=
-     * @param tree tree to which new tree is created
-     * @return reference to newly created tree
+     * Overwritten operator=, copies the tree and swaps the copy with this tree, so this tree is left
+     * unchanged if copying throws
+     * @param tree tree to be assigned
+     * @return reference to this tree
      */
     AVLTree& operator=(const AVLTree &tree) {
-        auto *newTree = new AVLTree(tree);
-        return *newTree;
+        AVLTree copy(tree);
+        std::swap(root, copy.root);
+        return *this;
     }
 
-};
\ No newline at end of file
+};
+
+#endif //LAB_AVLTREE_CPP
@@ -0,0 +1,776 @@
+#ifndef LAB_ARRAYRING_CPP
+#define LAB_ARRAYRING_CPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <utility>
+#include <vector>
+#include "Ring.cpp"
+
+using namespace std;
+
+/**
+ * Array of N elements kept inside an object, nothing for N = 0
+ * @tparam E type of element
+ * @tparam N number of elements
+ */
+template<typename E, size_t N>
+struct InlineBuffer {
+    /**
+     * elements
+     */
+    E elements[N];
+
+    /**
+     * Returns the array
+     * @return first element
+     */
+    E *get() { return elements; }
+};
+
+/**
+ * Empty InlineBuffer
+ * @tparam E type of element
+ */
+template<typename E>
+struct InlineBuffer<E, 0> {
+    /**
+     * Returns the array
+     * @return nullptr
+     */
+    E *get() { return nullptr; }
+};
+
+/**
+ * Ring that keeps its elements in a growable circular array whose capacity is a power of two.
+ * Element at logical position i is kept at index (start + i) & (capacity - 1), so moving an iterator
+ * by k positions is index arithmetic modulo size and appending is amortised O(1) without allocating
+ * a node per element. Rotating and reversing only change the mapping from logical positions to
+ * indices, so they are O(1). Public interface and iterator semantics are the same as of Ring with
+ * LinkedStorage. Adding elements may reallocate the array, which invalidates pointers to elements
+ * but not iterators, as iterators keep logical positions.
+ *
+ * With InlineStorage<N> the first array is a buffer of N elements inside the ring object, so a ring
+ * of at most N elements does not allocate at all. When it grows beyond N, elements are moved to the
+ * heap as with ArrayStorage, which is InlineStorage<0>.
+ * @tparam t1 key
+ * @tparam t2 info
+ * @tparam N number of elements kept inside the ring object, 0 or a power of two
+ */
+template<typename t1, typename t2, size_t N>
+class Ring<t1, t2, InlineStorage<N>> {
+    static_assert((N & (N - 1)) == 0, "Inline capacity has to be 0 or a power of two");
+
+    /**
+     * Structure that holds an element of the ring
+     */
+    struct Element {
+        /**
+         * key
+         */
+        t1 key;
+        /**
+         * info
+         */
+        t2 info;
+
+        /**
+         * Friend function used to printing iterator using cout
+         * @param output
+         * @param show
+         * @return ostream
+         */
+        friend ostream &operator<<(ostream &output, const Element &show) {
+            output << show.key << " " << show.info << endl;
+            return output;
+        }
+    };
+
+    /**
+     * elements kept inside the ring object
+     */
+    InlineBuffer<Element, N> buffer;
+
+    /**
+     * circular array of elements, buffer or array on the heap
+     */
+    Element *data;
+
+    /**
+     * size of data, N or a power of two greater than N
+     */
+    size_t capacity;
+
+    /**
+     * index in data of the first element
+     */
+    size_t start;
+
+    /**
+     * number of elements
+     */
+    size_t count;
+
+    /**
+     * number of positions the ring was rotated by since elements were last laid out in order
+     */
+    size_t offset;
+
+    /**
+     * true if logical order is opposite to order in data
+     */
+    bool reversed;
+
+    /**
+     * Returns element at logical position
+     * @param index position counted from the first element, less than count
+     * @return element
+     */
+    Element &slot(size_t index) const {
+        size_t position = index + offset < count ? index + offset : index + offset - count;
+        if (reversed) position = count - 1 - position;
+        return data[(start + position) & (capacity - 1)];
+    }
+
+    /**
+     * Moves elements to a new array of given capacity, first element is moved to index 0
+     * @param size new capacity, power of two not less than count
+     */
+    void reallocate(size_t size) {
+        Element *bigger = new Element[size];
+        for (size_t i = 0; i < count; i++) bigger[i] = std::move(slot(i));
+        if (!isInline()) delete[] data;
+        data = bigger;
+        capacity = size;
+        start = 0;
+        offset = 0;
+        reversed = false;
+    }
+
+    /**
+     * Lays elements out in logical order after rotate or reverse, so that the first element is at start
+     * and the ring can grow or shrink at both ends. A rotated ring that is not reversed is laid out by
+     * moving the elements on the shorter side of the rotation point across the free part of the array and
+     * moving start, which costs O(min(offset, count - offset)), and nothing if the array is full. Otherwise
+     * elements are rotated and reversed in place, which costs O(capacity) and allocates nothing.
+     */
+    void normalize() {
+        if (count != 0 && !reversed && offset != 0) {
+            size_t mask = capacity - 1, rest = count - offset, free = capacity - count;
+            if (free == 0) {
+                start = (start + offset) & mask;
+                offset = 0;
+            } else if (offset <= rest && offset <= free) {
+                for (size_t i = 0; i < offset; i++)
+                    data[(start + count + i) & mask] = std::move(data[(start + i) & mask]);
+                start = (start + offset) & mask;
+                offset = 0;
+            } else if (rest <= free) {
+                for (size_t i = 0; i < rest; i++)
+                    data[(start - rest + i) & mask] = std::move(data[(start + offset + i) & mask]);
+                start = (start - rest) & mask;
+                offset = 0;
+            }
+        }
+        if (count != 0 && (offset != 0 || reversed)) {
+            std::rotate(data, data + start, data + capacity);
+            start = 0;
+            if (reversed) std::reverse(data, data + count);
+            std::rotate(data, data + offset, data + count);
+        }
+        offset = 0;
+        reversed = false;
+    }
+
+    /**
+     * Checks if elements are kept in the inline buffer
+     * @return true if data is the buffer
+     */
+    bool isInline() const { return N != 0 && data == const_cast<InlineBuffer<Element, N> &>(buffer).get(); }
+
+    /**
+     * Takes over elements of other ring, which is left empty. This ring has to be empty. Heap array is
+     * taken over in O(1), elements from inline buffer are moved one by one.
+     * @param other ring whose elements are taken
+     */
+    void take(Ring &other) {
+        if (other.isInline()) {
+            for (size_t i = 0; i < other.count; i++) data[i] = std::move(other.slot(i));
+            count = other.count;
+            other.destroy();
+            return;
+        }
+        data = other.data;
+        capacity = other.capacity;
+        start = other.start;
+        count = other.count;
+        offset = other.offset;
+        reversed = other.reversed;
+        other.data = other.buffer.get();
+        other.capacity = N;
+        other.start = other.count = other.offset = 0;
+        other.reversed = false;
+    }
+
+    /**
+     * Makes space for one more element
+     */
+    void grow() {
+        if (count == capacity) reallocate(capacity ? capacity * 2 : 8);
+    }
+
+public:
+    /**
+     * Class object that iterates throughout full ring. It keeps logical position of the element,
+     * so moving it by any number of positions costs O(1).
+     * @tparam K key
+     * @tparam I info
+     */
+    template<typename K, typename I>
+    class Iterator {
+        /**
+         * iterated ring, nullptr for iterator that does not point to any element
+         */
+        Ring *ring;
+        /**
+         * logical position in the ring
+         */
+        size_t index;
+    public:
+        /**
+         * Default constructor
+         */
+        Iterator() : ring(nullptr), index(0) {}
+
+        /**
+         * Constructor with ring and position iterator points to
+         * @param ring ring
+         * @param index position in the ring
+         */
+        Iterator(Ring *ring, size_t index) : ring(ring && ring->count ? ring : nullptr), index(index) {}
+
+        /**
+         * Overwritten operator +. It moves iterator by length position forwards
+         * @param length number by which iterator is moved forwards
+         * @return iterator
+         */
+        Iterator operator+(int length) {
+            if (ring && length > 0) index = (index + length % ring->count) % ring->count;
+            return *this;
+        }
+
+        /**
+         * Overwritten operator +. It moves iterator by length position backword
+         * @param length number by which iterator is moved backword
+         * @return iterator
+         */
+        Iterator operator-(int length) {
+            if (ring && length > 0) index = (index + ring->count - length % ring->count) % ring->count;
+            return *this;
+        }
+
+        /**
+         * Overwritten operator ++. Moves forward by one
+         * @return iterator
+         */
+        Iterator &operator++() {
+            if (ring && ++index == ring->count) index = 0;
+            return *this;
+        }
+
+        /**
+         * Overwritten operator ++. Moves forward by one
+         * @return iterator before moving
+         */
+        Iterator operator++(int) {
+            Iterator temporary(*this);
+            ++*this;
+            return temporary;
+        }
+
+        /**
+         * Overwritten operator --. Moves backword by one
+         * @return iterator
+         */
+        Iterator &operator--() {
+            if (ring) index = (index ? index : ring->count) - 1;
+            return *this;
+        }
+
+        /**
+         * Overwritten operator --. Moves backword by one
+         * @return iterator before moving
+         */
+        Iterator operator--(int) {
+            Iterator temporary(*this);
+            --*this;
+            return temporary;
+        }
+
+        /**
+         * Overwritten operator ==, compares to iterators
+         * @param iterator iterator to be compared
+         * @return true if iterators point to same object, false otherwise
+         */
+        bool operator==(Iterator iterator) const { return ring == iterator.ring && index == iterator.index; }
+
+        /**
+         * Overwritten operator ==, compares to iterators
+         * @param iterator iterator to be compared
+         * @return false if iterators point to same object, true otherwise
+         */
+        bool operator!=(Iterator iterator) const { return !(*this == iterator); }
+
+        /**
+         * Overwritten operator *, return object via accessing pointer
+         * @return iterator object
+         */
+        Element &operator*() const { return ring->slot(index); }
+
+        /**
+         * Overwritten operator->. Used to access iterator pointer
+         * @return iterator pointer
+         */
+        Element *operator->() const { return &ring->slot(index); }
+
+        /**
+         * returns key
+         * @return key
+         */
+        t1 getKey() { return ring->slot(index).key; }
+
+        /**
+         * returns info
+         * @return info
+         */
+        t2 getInfo() { return ring->slot(index).info; }
+
+        /**
+         * Friend function used to printing ring using cout
+         * @param output output
+         * @param iter iterator
+         * @return ostream
+         */
+        friend ostream &operator<<(ostream &output, const Iterator &iter) {
+            output << *iter;
+            return output;
+        }
+    };
+
+    typedef Iterator<t1, t2> RingIterator;
+    typedef Iterator<const t1, const t2> ConstRingIterator;
+
+    /**
+     * returns iterator to begin
+     * @return begin iterator
+     */
+    RingIterator begin() { return RingIterator(this, 0); }
+
+    /**
+     * returns iterator to end
+     * @return end interator
+     */
+    RingIterator end() { return RingIterator(this, 0); }
+
+    /**
+     * returns iterator to last element
+     * @return iterator to last element
+     */
+    RingIterator last() { return RingIterator(this, count ? count - 1 : 0); }
+
+    /**
+     * Searches for iterator with given value
+     * @param value value
+     * @return iterator with given value
+     */
+    RingIterator find(const t1 &value) {
+        for (size_t i = 0; i < count; i++) if (slot(i).key == value) return RingIterator(this, i);
+        return RingIterator();
+    }
+
+    /**
+     * returns iterator pointing to the first element
+     * @return iterator pointing to the first element
+     */
+    ConstRingIterator constBegin() const { return ConstRingIterator(const_cast<Ring *>(this), 0); }
+
+    /**
+     * returns iterator pointing to the last element
+     * @return iterator pointing to the last element
+     */
+    ConstRingIterator constEnd() const { return ConstRingIterator(const_cast<Ring *>(this), 0); }
+
+    /**
+     * returns last iterator
+     * @return last iterator
+     */
+    ConstRingIterator constLast() const { return ConstRingIterator(const_cast<Ring *>(this), count ? count - 1 : 0); }
+
+    /**
+     * Look for iterator with given value
+     * @param value value
+     * @return iterator with given value
+     */
+    ConstRingIterator constFind(const t1 &value) const {
+        for (size_t i = 0; i < count; i++)
+            if (slot(i).key == value) return ConstRingIterator(const_cast<Ring *>(this), i);
+        return ConstRingIterator();
+    }
+
+    /**
+     * default constructor
+     */
+    Ring() : buffer(), data(buffer.get()), capacity(N), start(0), count(0), offset(0), reversed(false) {}
+
+    /**
+     * destroyer
+     */
+    ~Ring() { destroy(); }
+
+    /**
+     * Copying constructor
+     * @param cc ring to be copied
+     */
+    Ring(const Ring &cc) : buffer(), data(buffer.get()), capacity(N), start(0), count(0), offset(0), reversed(false) {
+        if (!cc.isEmpty()) copy(cc);
+    }
+
+    /**
+     * Overwritten operator =
+     * @param rhs to which ring ring is asigned
+     * @return reference to the ring
+     */
+    Ring &operator=(const Ring &rhs) {
+        if (this == &rhs) return *this;
+        destroy();
+        if (!rhs.isEmpty()) copy(rhs);
+        return *this;
+    }
+
+    /**
+     * Moving constructor, takes over array of cc, which is left empty. Elements kept inline are moved
+     * one by one.
+     * @param cc ring to be moved
+     */
+    Ring(Ring &&cc) noexcept : Ring() { take(cc); }
+
+    /**
+     * Moving operator =, takes over array of rhs, which is left empty. Elements kept inline are moved
+     * one by one.
+     * @param rhs ring to be moved
+     * @return reference to the ring
+     */
+    Ring &operator=(Ring &&rhs) noexcept {
+        if (this == &rhs) return *this;
+        destroy();
+        take(rhs);
+        return *this;
+    }
+
+    /**
+     * Makes sure that size elements fit without reallocating
+     * @param size number of elements
+     */
+    void reserve(size_t size) {
+        if (size <= capacity) return;
+        size_t bigger = capacity ? capacity : 8;
+        while (bigger < size) bigger *= 2;
+        reallocate(bigger);
+    }
+
+    /**
+     * adds key and value to the ring at end
+     * @param key key to be added
+     * @param info infor to be added
+     */
+    void addEnd(const t1 &key, const t2 &info) {
+        grow();
+        normalize();
+        Element &adder = data[(start + count) & (capacity - 1)];
+        adder.key = key;
+        adder.info = info;
+        count++;
+    }
+
+    /**
+     * adds key and value to the ring at begin, the same way as Ring with LinkedStorage does:
+     * new element is placed right after the first element, so the first element stays first
+     * @param key key to be added
+     * @param info infor to be added
+     */
+    void addBegin(const t1 &key, const t2 &info) {
+        if (count == 0) {
+            addEnd(key, info);
+            return;
+        }
+        grow();
+        normalize();
+        start = (start - 1) & (capacity - 1);
+        data[start].key = key;
+        data[start].info = info;
+        count++;
+        std::swap(slot(0), slot(1));
+    }
+
+    /**
+     * add given key and value to the ring
+     * @param iter iterator form which value and key are added
+     */
+    void add(const ConstRingIterator &iter) { addEnd(iter->key, iter->info); }
+
+    /**
+     * Rotates the ring in O(1), element that is steps positions after the first one becomes the first.
+     * Elements are not moved until the next insertion or removal, which lays them out in order again
+     * moving only the elements on the shorter side of the rotation point, so rotating by a few positions
+     * and then adding or removing an element costs O(1) amortised too.
+     * @param steps number of positions, negative rotates the other way
+     */
+    void rotate(long steps) {
+        if (count == 0) return;
+        long shift = steps % (long) count;
+        if (shift < 0) shift += count;
+        offset = (offset + shift) % count;
+    }
+
+    /**
+     * Reverses order of the ring in O(1), the last element becomes the first. Elements are not moved
+     * until the next insertion or removal, which lays them out in order again.
+     */
+    void reverse() {
+        if (count == 0) return;
+        reversed = !reversed;
+        offset = (count - offset) % count;
+    }
+
+    /**
+     * Checks if the ring was reversed since elements were last laid out in order
+     * @return true if logical order is opposite to order in the array
+     */
+    bool isReversed() const { return reversed; }
+
+    /**
+     * Sorts the ring by keys with std::stable_sort, the smallest key becomes the first element
+     * @tparam Compare comparator of keys
+     * @param comp returns true if first key goes before second
+     */
+    template<typename Compare = less<t1>>
+    void sort(Compare comp = Compare()) {
+        if (count < 2) return;
+        normalize();
+        std::rotate(data, data + start, data + capacity);
+        start = 0;
+        std::stable_sort(data, data + count,
+                         [&comp](const Element &a, const Element &b) { return comp(a.key, b.key); });
+    }
+
+    /**
+     * Moves all elements of other ring into this ring, both of them have to be sorted with comp.
+     * Elements of other are appended and both runs are merged with std::inplace_merge in O(n + m),
+     * other ring is left empty and elements of this ring go first among equal keys.
+     * @tparam Compare comparator of keys
+     * @param other sorted ring
+     * @param comp returns true if first key goes before second
+     */
+    template<typename Compare = less<t1>>
+    void merge(Ring &other, Compare comp = Compare()) {
+        if (this == &other || other.isEmpty()) return;
+        size_t middle = count;
+        splice(other);
+        normalize();
+        std::rotate(data, data + start, data + capacity);
+        start = 0;
+        std::inplace_merge(data, data + middle, data + count,
+                           [&comp](const Element &a, const Element &b) { return comp(a.key, b.key); });
+    }
+
+    /**
+     * Appends length elements of source ring, starting at logical position from and moving clockwise
+     * or counterclockwise, wrapping around source as many times as needed. Elements are copied in
+     * blocks that are contiguous both in source and in this ring's array, with std::copy, which turns
+     * into memmove for trivially copyable key and info.
+     * @param source ring from which elements are copied, may be this ring
+     * @param from logical position in source of the first copied element
+     * @param length number of elements to copy
+     * @param clockwise direction of moving in source
+     */
+    void appendRun(const Ring &source, size_t from, size_t length, bool clockwise) {
+        if (length == 0 || source.count == 0) return;
+        normalize();
+        reserve(count + length);
+        size_t size = source.count;
+        from %= size;
+        if (source.offset != 0 || source.reversed) {
+            for (; length > 0; length--) {
+                data[(start + count) & (capacity - 1)] = source.slot(from);
+                count++;
+                from = clockwise ? (from + 1) % size : (from + size - 1) % size;
+            }
+            return;
+        }
+        while (length > 0) {
+            size_t read = (source.start + from) & (source.capacity - 1);
+            size_t write = (start + count) & (capacity - 1);
+            size_t chunk;
+            if (clockwise) {
+                chunk = std::min(std::min(length, size - from), std::min(source.capacity - read, capacity - write));
+                std::copy(source.data + read, source.data + read + chunk, data + write);
+                from = (from + chunk) % size;
+            } else {
+                chunk = std::min(std::min(length, from + 1), std::min(read + 1, capacity - write));
+                std::reverse_copy(source.data + read + 1 - chunk, source.data + read + 1, data + write);
+                from = (from + size - chunk) % size;
+            }
+            count += chunk;
+            length -= chunk;
+        }
+    }
+
+    /**
+     * Moves all elements of other ring to the end of this ring, other ring is left empty.
+     * If this ring is empty it takes over the array in O(1), otherwise elements are moved in O(m).
+     * @param other ring whose elements are moved
+     */
+    void splice(Ring &other) {
+        if (this == &other || other.isEmpty()) return;
+        if (isEmpty()) {
+            *this = std::move(other);
+            return;
+        }
+        normalize();
+        reserve(count + other.count);
+        for (size_t i = 0; i < other.count; i++) {
+            Element &adder = data[(start + count) & (capacity - 1)];
+            adder = std::move(other.slot(i));
+            count++;
+        }
+        other.destroy();
+    }
+
+    /**
+     * Removes the first element with given key form the ring, if there is no such element nothing happens.
+     * Elements on the shorter side of the removed one are shifted to close the gap.
+     * @param value key of element to be removed
+     */
+    void remove(const t1 &value) {
+        normalize();
+        size_t position = 0;
+        while (position < count && slot(position).key != value) position++;
+        if (position == count) return;
+        if (position < count / 2) {
+            for (size_t i = position; i > 0; i--) slot(i) = std::move(slot(i - 1));
+            slot(0) = Element();
+            start = (start + 1) & (capacity - 1);
+        } else {
+            for (size_t i = position; i + 1 < count; i++) slot(i) = std::move(slot(i + 1));
+            slot(count - 1) = Element();
+        }
+        count--;
+    }
+
+    /**
+     * Checks if the ring has element with given key
+     * @param value key
+     * @return true if there is such element, false otherwise
+     */
+    bool contains(const t1 &value) const { return constFind(value) != ConstRingIterator(); }
+
+    /**
+     * Destroys ring
+     */
+    void destroy() {
+        if (isInline()) for (size_t i = 0; i < count; i++) slot(i) = Element();
+        else delete[] data;
+        data = buffer.get();
+        capacity = N;
+        start = count = offset = 0;
+        reversed = false;
+    }
+
+    /**
+     * Copies ring
+     * @param ring ring to copy
+     */
+    void copy(const Ring &ring) {
+        reserve(count + ring.count);
+        for (size_t i = 0; i < ring.count; i++) addEnd(ring.slot(i).key, ring.slot(i).info);
+    }
+
+    /**
+     * Returns number of elements
+     * @return number of elements
+     */
+    size_t size() const { return count; }
+
+    /**
+     * Part of the ring: length consecutive elements starting at first
+     * @tparam Iterator RingIterator or ConstRingIterator
+     */
+    template<typename Iterator>
+    struct BasicSegment {
+        /**
+         * first element of the segment
+         */
+        Iterator first;
+        /**
+         * number of elements
+         */
+        size_t length;
+    };
+
+    typedef BasicSegment<RingIterator> Segment;
+    typedef BasicSegment<ConstRingIterator> ConstSegment;
+
+    /**
+     * Cuts the ring into parts consecutive segments whose lengths differ by at most one, covering it
+     * exactly once starting at the first element. Positions are computed, so it costs O(parts).
+     * @param parts number of segments, lowered to size() if the ring is smaller
+     * @return segments in order of iteration, empty if ring is empty or parts is 0
+     */
+    vector<Segment> segments(size_t parts) {
+        vector<Segment> result;
+        if (count == 0 || parts == 0) return result;
+        if (parts > count) parts = count;
+        for (size_t i = 0; i < parts; i++) {
+            size_t begin = i * count / parts, end = (i + 1) * count / parts;
+            result.push_back({RingIterator(this, begin), end - begin});
+        }
+        return result;
+    }
+
+    /**
+     * Cuts the ring into segments as segments() does, for scans that do not change it
+     * @param parts number of segments, lowered to size() if the ring is smaller
+     * @return segments in order of iteration, empty if ring is empty or parts is 0
+     */
+    vector<ConstSegment> segments(size_t parts) const {
+        vector<ConstSegment> result;
+        if (count == 0 || parts == 0) return result;
+        if (parts > count) parts = count;
+        for (size_t i = 0; i < parts; i++) {
+            size_t begin = i * count / parts, end = (i + 1) * count / parts;
+            result.push_back({ConstRingIterator(const_cast<Ring *>(this), begin), end - begin});
+        }
+        return result;
+    }
+
+    /**
+     * Returns true is ring is not empty, false if it is
+     * @return true is ring is not empty, false if it is
+     */
+    bool isEmpty() const { return count == 0; }
+
+    /**
+     * Friend function used to printing ring using cout
+     * @param output output
+     * @param ring ring
+     * @return ostream
+     */
+    friend ostream &operator<<(ostream &output, const Ring &ring) {
+        for (size_t i = 0; i < ring.count; i++) output << ring.slot(i).key << " " << ring.slot(i).info << endl;
+        return output;
+    }
+};
+
+#endif //LAB_ARRAYRING_CPP
@@ -0,0 +1,535 @@
+//
+// Micro-benchmarks of containers of the lab against std::map, std::list and std::vector.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include "AVLTree.cpp"
+#include "Ring.cpp"
+#include "ArrayRing.cpp"
+#include "Produce.cpp"
+#include "Sequence.cpp"
+
+using namespace std;
+
+/**
+ * Results of benchmarks are added to it, so that compiler can not drop the work as unused
+ */
+volatile size_t sink;
+
+/**
+ * Options given in command line
+ */
+struct Options {
+    /**
+     * the smallest number of elements
+     */
+    size_t minSize = 1000;
+    /**
+     * the largest number of elements, sizes grow ten times from minSize up to it
+     */
+    size_t maxSize = 1000000;
+    /**
+     * only benchmarks whose "benchmark/container" contains it are run
+     */
+    string filter;
+    /**
+     * upper bound of operations of a benchmark whose every operation costs O(n)
+     */
+    size_t linearWork = 100000000;
+};
+
+/**
+ * Writes results as JSON array of objects, one per benchmark
+ */
+class Report {
+    /**
+     * options
+     */
+    const Options &options;
+    /**
+     * true until the first result is written
+     */
+    bool first = true;
+
+    /**
+     * Asks kernel to reset peak resident set size of the process, works on Linux only
+     */
+    static void resetPeak() {
+        ofstream clear("/proc/self/clear_refs");
+        if (clear) clear << "5";
+    }
+
+    /**
+     * Returns peak resident set size of the process since the last resetPeak, or since start of the
+     * process where it can not be reset
+     * @return peak resident set size in kB
+     */
+    static long peakKilobytes() {
+        ifstream status("/proc/self/status");
+        string line;
+        while (getline(status, line))
+            if (line.compare(0, 6, "VmHWM:") == 0) return atol(line.c_str() + 6);
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+public:
+    /**
+     * Constructor with arguments, starts JSON array
+     * @param options options
+     */
+    Report(const Options &options) : options(options) { cout << "[\n"; }
+
+    /**
+     * Destructor, closes JSON array
+     */
+    ~Report() { cout << "\n]" << endl; }
+
+    /**
+     * Checks if benchmark is selected by filter
+     * @param benchmark name of benchmark
+     * @param container name of container
+     * @return true if benchmark shall be run
+     */
+    bool selected(const string &benchmark, const string &container) const {
+        return (benchmark + "/" + container).find(options.filter) != string::npos;
+    }
+
+    /**
+     * Number of operations of a benchmark whose every operation costs O(n), so that it stays within linearWork
+     * @param size number of elements
+     * @return number of operations, from 1 to size
+     */
+    size_t linearOperations(size_t size) const {
+        size_t operations = options.linearWork / (size ? size : 1);
+        return max<size_t>(1, min(size, operations));
+    }
+
+    /**
+     * Runs and reports benchmark. Preparation is run before timing starts, its memory is counted in peak
+     * resident set size, but not in time.
+     * @tparam Prepare callable without arguments returning state of benchmark
+     * @tparam Body callable with the state, performing operations
+     * @param benchmark name of benchmark
+     * @param container name of container
+     * @param size number of elements
+     * @param operations number of operations performed by body
+     * @param prepare preparation
+     * @param body measured operations
+     */
+    template<typename Prepare, typename Body>
+    void run(const string &benchmark, const string &container, size_t size, size_t operations, Prepare prepare,
+             Body body) {
+        if (!selected(benchmark, container)) return;
+        resetPeak();
+        auto state = prepare();
+        auto start = chrono::steady_clock::now();
+        body(state);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        long peak = peakKilobytes();
+        double nanoseconds = seconds * 1e9 / operations;
+        cout << (first ? "" : ",\n") << "  {\"benchmark\": \"" << benchmark << "\", \"container\": \"" << container
+             << "\", \"size\": " << size << ", \"operations\": " << operations << ", \"ns_per_op\": " << nanoseconds
+             << ", \"ops_per_s\": " << (seconds > 0 ? operations / seconds : 0) << ", \"peak_rss_kb\": " << peak
+             << "}" << flush;
+        first = false;
+    }
+};
+
+/**
+ * Returns keys 0 ... size - 1 in random order, the same for every run
+ * @param size number of keys
+ * @return shuffled keys
+ */
+vector<int> shuffledKeys(size_t size) {
+    vector<int> keys(size);
+    iota(keys.begin(), keys.end(), 0);
+    shuffle(keys.begin(), keys.end(), mt19937(2018));
+    return keys;
+}
+
+/**
+ * Benchmarks of AVLTree and std::map
+ * @param report report
+ * @param size number of elements
+ */
+void benchmarkTrees(Report &report, size_t size) {
+    typedef AVLTree<int, int> Tree;
+    const vector<int> keys = shuffledKeys(size);
+    auto empty = [] { return 0; };
+    auto filledTree = [&] {
+        auto *tree = new Tree();
+        for (int key : keys) tree->insert(key, key);
+        return unique_ptr<Tree>(tree);
+    };
+    auto filledMap = [&] {
+        map<int, int> filled;
+        for (int key : keys) filled.emplace(key, key);
+        return filled;
+    };
+
+    report.run("insert", "AVLTree", size, size, empty, [&](int) {
+        Tree tree;
+        for (int key : keys) tree.insert(key, key);
+        sink = sink + (tree.searchKey(keys[0]) != nullptr);
+        tree.clear();
+    });
+    report.run("insert", "std::map", size, size, empty, [&](int) {
+        map<int, int> baseline;
+        for (int key : keys) baseline.emplace(key, key);
+        sink = sink + baseline.size();
+    });
+
+    report.run("lookup", "AVLTree", size, size, filledTree, [&](unique_ptr<Tree> &tree) {
+        size_t found = 0;
+        for (int key : keys) found += tree->searchKey(key)->value == key;
+        sink = sink + found;
+    });
+    report.run("lookup", "std::map", size, size, filledMap, [&](map<int, int> &baseline) {
+        size_t found = 0;
+        for (int key : keys) found += baseline.find(key)->second == key;
+        sink = sink + found;
+    });
+
+    report.run("remove", "AVLTree", size, size, filledTree, [&](unique_ptr<Tree> &tree) {
+        for (int key : keys) tree->remove(key);
+        sink = sink + (tree->searchKey(keys[0]) != nullptr);
+    });
+    report.run("remove", "std::map", size, size, filledMap, [&](map<int, int> &baseline) {
+        for (int key : keys) baseline.erase(key);
+        sink = sink + baseline.size();
+    });
+
+    report.run("iteration", "AVLTree", size, size, filledTree, [&](unique_ptr<Tree> &tree) {
+        size_t total = 0;
+        for (auto it = tree->begin(); it != tree->end(); ++it) total += it->value;
+        sink = sink + total;
+    });
+    report.run("iteration", "std::map", size, size, filledMap, [&](map<int, int> &baseline) {
+        size_t total = 0;
+        for (const auto &element : baseline) total += element.second;
+        sink = sink + total;
+    });
+
+    report.run("copy", "AVLTree", size, size, filledTree, [&](unique_ptr<Tree> &tree) {
+        Tree copy(*tree);
+        sink = sink + (copy.searchKey(keys[0]) != nullptr);
+    });
+    report.run("copy", "std::map", size, size, filledMap, [&](map<int, int> &baseline) {
+        map<int, int> copy(baseline);
+        sink = sink + copy.size();
+    });
+}
+
+/**
+ * Benchmarks of Ring, both storages, and of std::list and std::vector
+ * @param report report
+ * @param size number of elements
+ */
+void benchmarkRings(Report &report, size_t size) {
+    typedef Ring<int, int> LinkedRing;
+    typedef Ring<int, int, ArrayStorage> FlatRing;
+    const vector<int> keys = shuffledKeys(size);
+    const size_t lookups = report.linearOperations(size);
+    auto empty = [] { return 0; };
+    auto filledRing = [&] {
+        auto *ring = new LinkedRing();
+        for (int key : keys) ring->addEnd(key, key);
+        return unique_ptr<LinkedRing>(ring);
+    };
+    auto filledIndexedRing = [&] {
+        auto ring = filledRing();
+        ring->enableIndex();
+        return ring;
+    };
+    auto filledFlatRing = [&] {
+        auto *ring = new FlatRing();
+        for (int key : keys) ring->addEnd(key, key);
+        return unique_ptr<FlatRing>(ring);
+    };
+    auto filledList = [&] { return list<int>(keys.begin(), keys.end()); };
+    auto filledVector = [&] { return vector<int>(keys.begin(), keys.end()); };
+
+    report.run("insert", "Ring", size, size, empty, [&](int) {
+        LinkedRing ring;
+        for (int key : keys) ring.addEnd(key, key);
+        sink = sink + ring.size();
+    });
+    report.run("insert", "Ring<ArrayStorage>", size, size, empty, [&](int) {
+        FlatRing ring;
+        for (int key : keys) ring.addEnd(key, key);
+        sink = sink + ring.size();
+    });
+    report.run("insert", "std::list", size, size, empty, [&](int) {
+        list<int> baseline;
+        for (int key : keys) baseline.push_back(key);
+        sink = sink + baseline.size();
+    });
+    report.run("insert", "std::vector", size, size, empty, [&](int) {
+        vector<int> baseline;
+        for (int key : keys) baseline.push_back(key);
+        sink = sink + baseline.size();
+    });
+
+    report.run("lookup", "Ring", size, lookups, filledRing, [&](unique_ptr<LinkedRing> &ring) {
+        size_t found = 0;
+        for (size_t i = 0; i < lookups; i++) found += ring->contains((int) i);
+        sink = sink + found;
+    });
+    report.run("lookup", "Ring+index", size, size, filledIndexedRing, [&](unique_ptr<LinkedRing> &ring) {
+        size_t found = 0;
+        for (int key : keys) found += ring->contains(key);
+        sink = sink + found;
+    });
+    report.run("lookup", "Ring<ArrayStorage>", size, lookups, filledFlatRing, [&](unique_ptr<FlatRing> &ring) {
+        size_t found = 0;
+        for (size_t i = 0; i < lookups; i++) found += ring->contains((int) i);
+        sink = sink + found;
+    });
+    report.run("lookup", "std::list", size, lookups, filledList, [&](list<int> &baseline) {
+        size_t found = 0;
+        for (size_t i = 0; i < lookups; i++) found += find(baseline.begin(), baseline.end(), (int) i) != baseline.end();
+        sink = sink + found;
+    });
+    report.run("lookup", "std::vector", size, lookups, filledVector, [&](vector<int> &baseline) {
+        size_t found = 0;
+        for (size_t i = 0; i < lookups; i++) found += find(baseline.begin(), baseline.end(), (int) i) != baseline.end();
+        sink = sink + found;
+    });
+
+    // without index every removal looks for its key first, so they are limited like lookups. Keys 0, 1, ...
+    // are at random positions, because containers are filled in order of shuffled keys
+    report.run("remove", "Ring", size, lookups, filledRing, [&](unique_ptr<LinkedRing> &ring) {
+        for (size_t i = 0; i < lookups; i++) ring->remove((int) i);
+        sink = sink + ring->size();
+    });
+    report.run("remove", "Ring+index", size, size, filledIndexedRing, [&](unique_ptr<LinkedRing> &ring) {
+        for (int key : keys) ring->remove(key);
+        sink = sink + ring->size();
+    });
+    report.run("remove", "std::list", size, lookups, filledList, [&](list<int> &baseline) {
+        for (size_t i = 0; i < lookups; i++) baseline.erase(find(baseline.begin(), baseline.end(), (int) i));
+        sink = sink + baseline.size();
+    });
+    report.run("remove", "std::vector", size, lookups, filledVector, [&](vector<int> &baseline) {
+        for (size_t i = 0; i < lookups; i++) baseline.erase(find(baseline.begin(), baseline.end(), (int) i));
+        sink = sink + baseline.size();
+    });
+
+    report.run("iteration", "Ring", size, size, filledRing, [&](unique_ptr<LinkedRing> &ring) {
+        size_t total = 0;
+        auto it = ring->begin();
+        for (size_t i = 0; i < ring->size(); i++, ++it) total += it->info;
+        sink = sink + total;
+    });
+    report.run("iteration", "Ring<ArrayStorage>", size, size, filledFlatRing, [&](unique_ptr<FlatRing> &ring) {
+        size_t total = 0;
+        auto it = ring->begin();
+        for (size_t i = 0; i < ring->size(); i++, ++it) total += it->info;
+        sink = sink + total;
+    });
+    report.run("iteration", "std::list", size, size, filledList, [&](list<int> &baseline) {
+        sink = sink + accumulate(baseline.begin(), baseline.end(), (size_t) 0);
+    });
+    report.run("iteration", "std::vector", size, size, filledVector, [&](vector<int> &baseline) {
+        sink = sink + accumulate(baseline.begin(), baseline.end(), (size_t) 0);
+    });
+
+    report.run("copy", "Ring", size, size, filledRing, [&](unique_ptr<LinkedRing> &ring) {
+        LinkedRing copy(*ring);
+        sink = sink + copy.size();
+    });
+    report.run("copy", "Ring<ArrayStorage>", size, size, filledFlatRing, [&](unique_ptr<FlatRing> &ring) {
+        FlatRing copy(*ring);
+        sink = sink + copy.size();
+    });
+    report.run("copy", "std::list", size, size, filledList, [&](list<int> &baseline) {
+        list<int> copy(baseline);
+        sink = sink + copy.size();
+    });
+    report.run("copy", "std::vector", size, size, filledVector, [&](vector<int> &baseline) {
+        vector<int> copy(baseline);
+        sink = sink + copy.size();
+    });
+
+    // produce() takes 3 elements of the first ring and 2 of the second one size / 5 times
+    int times = (int) (size / 5);
+    report.run("produce", "Ring", size, size, filledRing, [&](unique_ptr<LinkedRing> &ring) {
+        LinkedRing produced = produce(*ring, 0, 3, *ring, 1, 2, times, true, false, false);
+        sink = sink + produced.size();
+    });
+    report.run("produce", "Ring<ArrayStorage>", size, size, filledFlatRing, [&](unique_ptr<FlatRing> &ring) {
+        FlatRing produced = produce(*ring, 0, 3, *ring, 1, 2, times, true, false, false);
+        sink = sink + produced.size();
+    });
+    report.run("produce", "std::vector", size, size, filledVector, [&](vector<int> &baseline) {
+        vector<int> produced;
+        size_t first = 0, second = 1 % size;
+        for (int i = 0; i < times; i++) {
+            for (int j = 0; j < 3; j++, first = first + 1 == size ? 0 : first + 1) produced.push_back(baseline[first]);
+            for (int j = 0; j < 2; j++, second = second == 0 ? size - 1 : second - 1) produced.push_back(baseline[second]);
+        }
+        sink = sink + produced.size();
+    });
+}
+
+/**
+ * Benchmarks of MyRing and Sequence
+ * @param report report
+ * @param size number of elements
+ */
+void benchmarkSequences(Report &report, size_t size) {
+    typedef MyRing<int, int> List;
+    const vector<int> keys = shuffledKeys(size);
+    const size_t lookups = report.linearOperations(size);
+    auto empty = [] { return 0; };
+    auto filledList = [&] {
+        List filled;
+        for (int key : keys) filled.push_back(key, key);
+        return filled;
+    };
+    auto filledSequence = [&] {
+        Sequence<int, int> filled;
+        for (int key : keys) filled.addElement(key, key);
+        return filled;
+    };
+    auto sortedSequence = [&] {
+        Sequence<int, int> filled;
+        for (size_t key = 0; key < size; key++) filled.addElement((int) key, (int) key);
+        return filled;
+    };
+    auto indexedSequence = [&] {
+        Sequence<int, int> filled = filledSequence();
+        filled.enableIndex();
+        return filled;
+    };
+
+    report.run("insert", "MyRing", size, size, empty, [&](int) {
+        List filled;
+        for (int key : keys) filled.push_back(key, key);
+        sink = sink + filled.size();
+    });
+    report.run("insert", "Sequence", size, size, empty, [&](int) {
+        Sequence<int, int> filled;
+        for (int key : keys) filled.addElement(key, key);
+        sink = sink + filled.getList().size();
+    });
+
+    // access by position, not by key, so it is reported apart from key lookups
+    report.run("positional", "MyRing", size, size, filledList, [&](const List &filled) {
+        size_t total = 0;
+        for (int key : keys) total += filled[key].info;
+        sink = sink + total;
+    });
+    report.run("positional", "std::vector", size, size, [&] { return vector<int>(keys.begin(), keys.end()); },
+               [&](const vector<int> &baseline) {
+                   size_t total = 0;
+                   for (int key : keys) total += baseline[key];
+                   sink = sink + total;
+               });
+    report.run("lookup", "Sequence", size, lookups, filledSequence, [&](Sequence<int, int> &filled) {
+        size_t total = 0;
+        for (size_t i = 0; i < lookups; i++) total += filled.getInfo((int) i);
+        sink = sink + total;
+    });
+    report.run("lookup", "Sequence+sorted", size, size, sortedSequence, [&](Sequence<int, int> &filled) {
+        size_t total = 0;
+        for (int key : keys) total += filled.getInfo(key);
+        sink = sink + total;
+    });
+    report.run("lookup", "Sequence+index", size, size, indexedSequence, [&](Sequence<int, int> &filled) {
+        size_t total = 0;
+        for (int key : keys) total += filled.getInfo(key);
+        sink = sink + total;
+    });
+
+    report.run("iteration", "MyRing", size, size, filledList, [&](const List &filled) {
+        size_t total = 0;
+        const Element<int, int> *curr = filled.head;
+        for (size_t i = 0; i < filled.size(); i++, curr = curr->next) total += curr->info;
+        sink = sink + total;
+    });
+
+    // MyRing and Sequence can not remove single elements, clear is the only removal they have
+    report.run("clear", "MyRing", size, size, filledList, [&](List &filled) {
+        filled.clear();
+        sink = sink + filled.size();
+    });
+    report.run("clear", "Sequence", size, size, filledSequence, [&](Sequence<int, int> &filled) {
+        filled.list.clear();
+        sink = sink + filled.getList().size();
+    });
+    report.run("clear", "std::list", size, size, [&] { return list<int>(keys.begin(), keys.end()); },
+               [&](list<int> &baseline) {
+                   baseline.clear();
+                   sink = sink + baseline.size();
+               });
+    report.run("clear", "std::vector", size, size, [&] { return vector<int>(keys.begin(), keys.end()); },
+               [&](vector<int> &baseline) {
+                   baseline.clear();
+                   sink = sink + baseline.size();
+               });
+
+    report.run("copy", "MyRing", size, size, filledList, [&](const List &filled) {
+        List copy(filled);
+        copy.push_back(0, 0);
+        sink = sink + copy.size();
+    });
+    report.run("copy", "Sequence", size, size, filledSequence, [&](const Sequence<int, int> &filled) {
+        Sequence<int, int> copy(filled);
+        copy.addElement(0, 0);
+        sink = sink + copy.getList().size();
+    });
+}
+
+/**
+ * Runs benchmarks for sizes from --min to --max, growing ten times, and prints JSON array of results.
+ * Options: --min N, --max N (up to 100000000), --filter TEXT selecting "benchmark/container",
+ * --linear-work N bounding work of O(n) lookups and removals.
+ */
+int main(int argc, char **argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (i + 1 == argc) {
+            cerr << "Missing value of " << option << endl;
+            return 1;
+        }
+        string value = argv[++i];
+        if (option == "--min") options.minSize = strtoull(value.c_str(), nullptr, 10);
+        else if (option == "--max") options.maxSize = strtoull(value.c_str(), nullptr, 10);
+        else if (option == "--filter") options.filter = value;
+        else if (option == "--linear-work") options.linearWork = strtoull(value.c_str(), nullptr, 10);
+        else {
+            cerr << "Unknown option " << option << endl;
+            return 1;
+        }
+    }
+    if (options.minSize == 0 || options.maxSize > 100000000) {
+        cerr << "Sizes have to be from 1 to 100000000" << endl;
+        return 1;
+    }
+    Report report(options);
+    for (size_t size = options.minSize; size <= options.maxSize; size *= 10) {
+        benchmarkTrees(report, size);
+        benchmarkRings(report, size);
+        benchmarkSequences(report, size);
+    }
+    return 0;
+}
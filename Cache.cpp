@@ -0,0 +1,279 @@
+#ifndef LAB_CACHE_CPP
+#define LAB_CACHE_CPP
+
+#include <cstddef>
+#include <stdexcept>
+#include "Ring.cpp"
+#include "AVLTree.cpp"
+
+/**
+ * Bounded cache that keeps at most capacity entries. Entries are looked up by key in an AVLTree,
+ * which maps key to a handle of an element in a Ring. The Ring keeps entries in recency order.
+ * Two replacement policies are available:
+ * LRU - on every hit the entry is relinked to the head of the ring, the entry before head
+ * (least recently used) is evicted.
+ * CLOCK - on hit only a reference bit is set, nothing is relinked. On eviction a hand sweeps
+ * the ring clearing reference bits and evicts first entry that was not referenced.
+ * Hit path does not allocate, it descends the tree and touches a single ring element.
+ * @tparam t1 type of key, it needs to have overwritten operators: >, <, =, ==, !=
+ * @tparam t2 type of value
+ */
+template<typename t1, typename t2>
+class Cache {
+public:
+    /**
+     * Replacement policy of the cache
+     */
+    enum Policy {
+        LRU,
+        CLOCK
+    };
+
+private:
+    /**
+     * Value kept in the ring together with reference bit used by CLOCK policy
+     */
+    struct Entry {
+        /**
+         * cached value
+         */
+        t2 value;
+        /**
+         * true if entry was hit since the hand passed it last time
+         */
+        bool referenced;
+    };
+
+    typedef typename Ring<t1, Entry>::Handle Handle;
+
+    /**
+     * entries in recency order
+     */
+    Ring<t1, Entry> order;
+
+    /**
+     * key to ring element lookup
+     */
+    AVLTree<t1, Handle> lookup;
+
+    /**
+     * clock hand, used only by CLOCK policy
+     */
+    Handle hand;
+
+    /**
+     * replacement policy
+     */
+    Policy policy;
+
+    /**
+     * maximal number of entries
+     */
+    size_t maxSize;
+
+    /**
+     * current number of entries
+     */
+    size_t entries;
+
+    /**
+     * number of hits
+     */
+    size_t hits;
+
+    /**
+     * number of misses
+     */
+    size_t misses;
+
+    /**
+     * number of evicted entries
+     */
+    size_t evictions;
+
+    /**
+     * Chooses victim according to policy
+     * @return element to be evicted
+     */
+    Handle victim() {
+        if (policy == LRU) return order.getHead()->prev;
+        while (hand->info.referenced) {
+            hand->info.referenced = false;
+            hand = hand->next;
+        }
+        return hand;
+    }
+
+    /**
+     * Removes given element from both the ring and the tree
+     * @param element element to be removed
+     */
+    void drop(Handle element) {
+        if (element == hand) hand = element->next != element ? element->next : nullptr;
+        lookup.remove(element->key);
+        order.erase(element);
+        entries--;
+    }
+
+    /**
+     * Marks entry as recently used
+     * @param element element that was hit
+     */
+    void touch(Handle element) {
+        if (policy == LRU) order.moveToFront(element);
+        else element->info.referenced = true;
+    }
+
+public:
+    /**
+     * Constructor with arguments
+     * @param capacity maximal number of entries, has to be greater than 0
+     * @param policy replacement policy
+     */
+    Cache(size_t capacity, Policy policy = LRU) {
+        if (capacity == 0) throw std::invalid_argument("Cache capacity has to be greater than 0");
+        hand = nullptr;
+        this->policy = policy;
+        maxSize = capacity;
+        entries = 0;
+        hits = misses = evictions = 0;
+    }
+
+    /**
+     * Cache holds handles to its own elements, so it can not be copied
+     */
+    Cache(const Cache &) = delete;
+
+    /**
+     * Cache holds handles to its own elements, so it can not be copied
+     */
+    Cache &operator=(const Cache &) = delete;
+
+    /**
+     * Looks for value with given key and counts hit or miss
+     * @param key key
+     * @return pointer to cached value or nullptr if there is no such key
+     */
+    t2 *get(const t1 &key) {
+        auto *node = lookup.searchKey(key);
+        if (node == nullptr) {
+            misses++;
+            return nullptr;
+        }
+        hits++;
+        Handle element = node->value;
+        touch(element);
+        return &element->info.value;
+    }
+
+    /**
+     * Inserts value with given key, if key is already cached its value is replaced.
+     * If cache is full one entry is evicted.
+     * @param key key
+     * @param value value
+     * @return reference to cached value
+     */
+    t2 &put(const t1 &key, const t2 &value) {
+        auto *node = lookup.searchKey(key);
+        if (node != nullptr) {
+            Handle element = node->value;
+            element->info.value = value;
+            touch(element);
+            return element->info.value;
+        }
+        if (entries == maxSize) {
+            drop(victim());
+            evictions++;
+        }
+        Entry entry;
+        entry.value = value;
+        entry.referenced = false;
+        Handle element;
+        if (policy == LRU) {
+            element = order.addEnd(key, entry);
+            order.moveToFront(element);
+        } else {
+            element = order.insertBefore(hand, key, entry);
+            if (!hand) hand = element;
+        }
+        lookup.insert(key, element);
+        entries++;
+        return element->info.value;
+    }
+
+    /**
+     * Returns cached value, if there is no such key value is computed, cached and returned
+     * @tparam F type of function computing value
+     * @param key key
+     * @param compute function that takes key and returns value
+     * @return reference to cached value
+     */
+    template<typename F>
+    t2 &getOrCompute(const t1 &key, F compute) {
+        t2 *value = get(key);
+        if (value != nullptr) return *value;
+        return put(key, compute(key));
+    }
+
+    /**
+     * Checks if key is cached, does not count hit or miss and does not change recency
+     * @param key key
+     * @return true if key is cached, false otherwise
+     */
+    bool contains(const t1 &key) {
+        return lookup.searchKey(key) != nullptr;
+    }
+
+    /**
+     * Removes entry with given key, if there is no such key nothing happens
+     * @param key key
+     */
+    void remove(const t1 &key) {
+        auto *node = lookup.searchKey(key);
+        if (node != nullptr) drop(node->value);
+    }
+
+    /**
+     * Removes all entries, statistics are kept
+     */
+    void clear() {
+        while (entries > 0) drop(order.getHead());
+    }
+
+    /**
+     * Returns number of cached entries
+     * @return number of cached entries
+     */
+    size_t size() const { return entries; }
+
+    /**
+     * Returns maximal number of entries
+     * @return maximal number of entries
+     */
+    size_t capacity() const { return maxSize; }
+
+    /**
+     * Returns number of hits
+     * @return number of hits
+     */
+    size_t getHits() const { return hits; }
+
+    /**
+     * Returns number of misses
+     * @return number of misses
+     */
+    size_t getMisses() const { return misses; }
+
+    /**
+     * Returns number of evicted entries
+     * @return number of evicted entries
+     */
+    size_t getEvictions() const { return evictions; }
+
+    /**
+     * Sets hit, miss and eviction counters to 0
+     */
+    void resetStatistics() { hits = misses = evictions = 0; }
+};
+
+#endif //LAB_CACHE_CPP
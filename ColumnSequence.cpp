@@ -0,0 +1,195 @@
+#ifndef LAB_COLUMNSEQUENCE_CPP
+#define LAB_COLUMNSEQUENCE_CPP
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "List.cpp"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * Returns position of the first key equal to key, comparing one key at a time
+ * @tparam a0 type of key
+ * @param keys keys
+ * @param count number of keys
+ * @param key key to look for
+ * @return position of the first equal key, count if there is no such key
+ */
+template<typename a0>
+size_t scanKeys(const a0 *keys, size_t count, const a0 &key, ...) {
+    for (size_t i = 0; i < count; ++i) if (keys[i] == key) return i;
+    return count;
+}
+
+#ifdef __SSE2__
+/**
+ * Compares lanes of two vectors of keys, all bytes of a lane are set if lanes are equal
+ * @tparam a0 type of key
+ * @param keys vector of keys
+ * @param key vector filled with key to look for
+ * @return mask of equal lanes
+ */
+template<typename a0>
+__m128i equalLanes(__m128i keys, __m128i key) {
+    if (std::is_floating_point<a0>::value) {
+        if (sizeof(a0) == 4) return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(keys), _mm_castsi128_ps(key)));
+        return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(keys), _mm_castsi128_pd(key)));
+    }
+    switch (sizeof(a0)) {
+        case 1:
+            return _mm_cmpeq_epi8(keys, key);
+        case 2:
+            return _mm_cmpeq_epi16(keys, key);
+        case 4:
+            return _mm_cmpeq_epi32(keys, key);
+        default: {
+            // 64-bit lane is equal if both of its 32-bit halves are
+            __m128i halves = _mm_cmpeq_epi32(keys, key);
+            return _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+    }
+}
+
+/**
+ * Returns position of the first key equal to key, comparing a 16-byte vector of keys per step with SSE2.
+ * Used for integral keys of 1, 2, 4 or 8 bytes and for float and double, other keys are scanned one at a time.
+ * Floating point keys are compared as by ==, so NaN equals nothing and 0.0 equals -0.0.
+ * @tparam a0 type of key
+ * @param keys keys
+ * @param count number of keys
+ * @param key key to look for
+ * @return position of the first equal key, count if there is no such key
+ */
+template<typename a0, typename std::enable_if<
+        (std::is_integral<a0>::value && (sizeof(a0) == 1 || sizeof(a0) == 2 || sizeof(a0) == 4 || sizeof(a0) == 8)) ||
+        (std::is_floating_point<a0>::value && (sizeof(a0) == 4 || sizeof(a0) == 8)), int>::type = 0>
+size_t scanKeys(const a0 *keys, size_t count, const a0 &key, int) {
+    const size_t lanes = 16 / sizeof(a0);
+    alignas(16) unsigned char filled[16];
+    for (size_t lane = 0; lane < lanes; ++lane) std::memcpy(filled + lane * sizeof(a0), &key, sizeof(a0));
+    const __m128i wanted = _mm_load_si128(reinterpret_cast<const __m128i *>(filled));
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i));
+        int mask = _mm_movemask_epi8(equalLanes<a0>(block, wanted));
+        if (mask != 0) return i + __builtin_ctz(mask) / sizeof(a0);
+    }
+    for (; i < count; ++i) if (keys[i] == key) return i;
+    return count;
+}
+#endif
+
+/**
+ * Sequence of elements with arithmetic keys kept in columns: keys in one contiguous array and infos in
+ * a parallel one, element with index i is keys[i] and infos[i]. Key lookups scan the key column with
+ * SIMD compares where the platform has them, so unsorted sequences are searched quickly without
+ * any index memory. Lookups return the first element with given key, counting from index 0, like Sequence.
+ * @tparam a0 type of key, arithmetic
+ * @tparam a1 type of info
+ */
+template<typename a0, typename a1>
+class ColumnSequence {
+    static_assert(std::is_arithmetic<a0>::value, "ColumnSequence needs an arithmetic key type");
+
+    /**
+     * keys of elements
+     */
+    std::vector<a0> keys;
+
+    /**
+     * infos of elements, infos[i] belongs to keys[i]
+     */
+    std::vector<a1> infos;
+
+    /**
+     * Looks for position of the first element with given key
+     * @param key key
+     * @param position found position
+     * @return true if key was found, false otherwise
+     */
+    bool lookup(const a0 &key, size_t &position) const {
+        position = scanKeys(keys.data(), keys.size(), key, 0);
+        return position < keys.size();
+    }
+
+public:
+    /**
+     * Default constructor
+     */
+    ColumnSequence() = default;
+
+    /**
+     * Constructor with arguments
+     * @param elements elements
+     */
+    ColumnSequence(const MyRing<a0, a1> &elements) {
+        keys.reserve(elements.size());
+        infos.reserve(elements.size());
+        const Element<a0, a1> *curr = elements.head;
+        for (size_t i = 0; i < elements.size(); ++i, curr = curr->next) addElement(curr->key, curr->info);
+    }
+
+    /**
+     * Returns info corresponding to key provided as the argument
+     * @param key key
+     * @return info of the first element with given key, a1() if there is no such element
+     */
+    a1 getInfo(a0 key) const {
+        size_t position;
+        return lookup(key, position) ? infos[position] : a1();
+    }
+
+    /**
+     * Adds an element
+     * @param key key of the element
+     * @param value value of the element
+     */
+    void addElement(a0 key, a1 value) {
+        keys.push_back(key);
+        infos.push_back(value);
+    }
+
+    /**
+     * Gets element
+     * @param index index of the element
+     * @return element at given index
+     */
+    Element<a0, a1> getElement(int index) const {
+        if (index < 0 || (size_t) index >= keys.size())
+            throw std::out_of_range("ColumnSequence index out of range");
+        return Element<a0, a1>(keys[index], infos[index], nullptr);
+    }
+
+    /**
+     * Gets element by key
+     * @param key key of the element
+     * @return the first element with given key
+     */
+    Element<a0, a1> getElementByKy(a0 key) const {
+        size_t position;
+        if (!lookup(key, position)) throw std::invalid_argument("Sequence has no element with given key");
+        return Element<a0, a1>(keys[position], infos[position], nullptr);
+    }
+
+    /**
+     * Returns number of elements
+     * @return number of elements
+     */
+    size_t size() const { return keys.size(); }
+
+    /**
+     * Compares two sequences, columns are compared one after another
+     * @param sequence sequence to compare
+     * @return true if sequences are equal, false if they are not
+     */
+    bool compare(const ColumnSequence &sequence) const {
+        return keys == sequence.keys && infos == sequence.infos;
+    }
+};
+
+#endif //LAB_COLUMNSEQUENCE_CPP
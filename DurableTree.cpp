@@ -0,0 +1,459 @@
+#ifndef LAB_DURABLETREE_CPP
+#define LAB_DURABLETREE_CPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include "AVLTree.cpp"
+
+using namespace std;
+
+/**
+ * Durability layer over AVLTree. Every insert and remove is appended as a record to an append-only
+ * log file before the call returns. Commits are grouped: a thread that finds no flush in progress
+ * becomes the leader, writes all records buffered so far with a single write and a single fdatasync,
+ * while other threads wait until their record is covered by a finished flush. Under concurrency many
+ * mutations share one sync, so throughput is bounded by disk bandwidth rather than sync latency.
+ *
+ * Files used are path.snapshot, full image of the tree written by checkpoint(), and path.log with
+ * records appended after the last checkpoint. Constructor loads the snapshot and replays the log on
+ * top of it. A torn record at the end of the log (crash in the middle of a write) is detected by its
+ * checksum and cut off.
+ *
+ * Mutations are applied to the tree before they are durable, so a concurrent reader may observe a
+ * change whose mutator has not returned yet.
+ *
+ * If writing or syncing the log fails, the tree is marked failed and stays so: records of the lost batch
+ * are never acknowledged, the log is cut back to its length before the batch, so nothing torn hides
+ * records written earlier, and every later insert, remove and checkpoint throws. The tree in memory may
+ * hold mutations of the lost batch, so it has to be reopened from disk.
+ * @tparam t1 type of key, std::string or trivially copyable
+ * @tparam t2 type of value, std::string or trivially copyable
+ */
+template<typename t1, typename t2>
+class DurableTree {
+    /**
+     * Type of record in the log
+     */
+    enum RecordType : uint8_t {
+        INSERT = 1,
+        REMOVE = 2
+    };
+
+    /**
+     * tree kept in memory
+     */
+    AVLTree<t1, t2> tree;
+
+    /**
+     * path of files without extension
+     */
+    string path;
+
+    /**
+     * descriptor of the log file
+     */
+    int log;
+
+    /**
+     * guards tree, buffer and sequence numbers
+     */
+    mutex guard;
+
+    /**
+     * signalled when a flush finishes
+     */
+    condition_variable flushed;
+
+    /**
+     * records not written yet
+     */
+    string buffer;
+
+    /**
+     * sequence number of the last buffered record
+     */
+    uint64_t appended;
+
+    /**
+     * sequence number of the last record that is on disk
+     */
+    uint64_t durable;
+
+    /**
+     * true while some thread writes and syncs the log
+     */
+    bool flushing;
+
+    /**
+     * true after a flush failed, the log holds only records up to durable
+     */
+    bool failed;
+
+    /**
+     * length of the log file, bytes of records up to durable
+     */
+    off_t logged;
+
+    /**
+     * Throws if a flush failed before
+     */
+    void checkFailed() const {
+        if (failed) throw runtime_error("DurableTree: log write failed earlier, reopen the tree");
+    }
+
+    /**
+     * fsyncs directory of the files, so that a rename in it is durable
+     */
+    void syncDirectory() const {
+        size_t slash = path.find_last_of('/');
+        string directory = slash == string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+        int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0) throw runtime_error("DurableTree: could not open " + directory);
+        int result = fsync(fd);
+        close(fd);
+        if (result != 0) throw runtime_error("DurableTree: could not sync " + directory);
+    }
+
+    /**
+     * FNV-1a checksum of given bytes
+     * @param data bytes
+     * @param length number of bytes
+     * @return checksum
+     */
+    static uint32_t checksum(const char *data, size_t length) {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < length; i++) {
+            hash ^= (unsigned char) data[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    /**
+     * Appends trivially copyable field to the buffer
+     * @tparam T type of field
+     * @param out buffer
+     * @param field field
+     */
+    template<typename T>
+    static void encode(string &out, const T &field) {
+        static_assert(is_trivially_copyable<T>::value, "DurableTree supports string or trivially copyable types");
+        out.append(reinterpret_cast<const char *>(&field), sizeof(T));
+    }
+
+    /**
+     * Appends string field to the buffer, it is prefixed by its length
+     * @param out buffer
+     * @param field field
+     */
+    static void encode(string &out, const string &field) {
+        encode(out, (uint32_t) field.size());
+        out.append(field);
+    }
+
+    /**
+     * Reads trivially copyable field
+     * @tparam T type of field
+     * @param pos position in data, moved behind the field
+     * @param end end of data
+     * @param field field to be read
+     * @return false if data is too short
+     */
+    template<typename T>
+    static bool decode(const char *&pos, const char *end, T &field) {
+        if (end - pos < (ptrdiff_t) sizeof(T)) return false;
+        memcpy(&field, pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    /**
+     * Reads string field prefixed by its length
+     * @param pos position in data, moved behind the field
+     * @param end end of data
+     * @param field field to be read
+     * @return false if data is too short
+     */
+    static bool decode(const char *&pos, const char *end, string &field) {
+        uint32_t length;
+        if (!decode(pos, end, length) || end - pos < (ptrdiff_t) length) return false;
+        field.assign(pos, length);
+        pos += length;
+        return true;
+    }
+
+    /**
+     * Reads whole file
+     * @param name path of file
+     * @param content content of file, empty if file does not exist
+     */
+    static void readFile(const string &name, string &content) {
+        content.clear();
+        FILE *file = fopen(name.c_str(), "rb");
+        if (!file) return;
+        char chunk[1 << 16];
+        size_t read;
+        while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) content.append(chunk, read);
+        fclose(file);
+    }
+
+    /**
+     * Writes whole buffer to descriptor
+     * @param fd descriptor
+     * @param data data
+     * @param length number of bytes
+     */
+    static void writeAll(int fd, const char *data, size_t length) {
+        while (length > 0) {
+            ssize_t written = ::write(fd, data, length);
+            if (written < 0) throw runtime_error("DurableTree: write failed");
+            data += written;
+            length -= written;
+        }
+    }
+
+    /**
+     * Builds a log record: type, payload length, payload and checksum of the payload
+     * @param type type of record
+     * @param payload encoded key, and value for insert
+     */
+    void frame(RecordType type, const string &payload) {
+        buffer.push_back((char) type);
+        encode(buffer, (uint32_t) payload.size());
+        buffer.append(payload);
+        encode(buffer, checksum(payload.data(), payload.size()));
+    }
+
+    /**
+     * Loads snapshot into the tree
+     */
+    void loadSnapshot() {
+        string content;
+        readFile(path + ".snapshot", content);
+        const char *pos = content.data(), *end = pos + content.size();
+        uint64_t count;
+        if (!decode(pos, end, count)) return;
+        t1 key;
+        t2 value;
+        for (uint64_t i = 0; i < count; i++) {
+            if (!decode(pos, end, key) || !decode(pos, end, value))
+                throw runtime_error("DurableTree: snapshot is corrupted");
+            tree.insert(key, value);
+        }
+    }
+
+    /**
+     * Replays log on top of the tree
+     * @return number of bytes of valid records, anything behind it is a torn write
+     */
+    size_t replayLog() {
+        string content;
+        readFile(path + ".log", content);
+        const char *begin = content.data(), *pos = begin, *end = begin + content.size();
+        size_t valid = 0;
+        while (pos < end) {
+            uint8_t type;
+            uint32_t length, sum;
+            if (!decode(pos, end, type) || !decode(pos, end, length) || end - pos < (ptrdiff_t) length) break;
+            const char *payload = pos, *payloadEnd = pos + length;
+            pos = payloadEnd;
+            if (!decode(pos, end, sum) || sum != checksum(payload, length)) break;
+            t1 key;
+            t2 value;
+            if (!decode(payload, payloadEnd, key)) break;
+            if (type == INSERT) {
+                if (!decode(payload, payloadEnd, value)) break;
+                tree.insert(key, value);
+            } else if (type == REMOVE) {
+                tree.remove(key);
+            } else break;
+            valid = pos - begin;
+        }
+        return valid;
+    }
+
+    /**
+     * Waits until record with given sequence number is on disk, becoming leader of a flush if needed
+     * @param lock lock of guard, held on entry and exit
+     * @param sequence sequence number of the record
+     */
+    void commit(unique_lock<mutex> &lock, uint64_t sequence) {
+        while (durable < sequence) {
+            checkFailed();
+            if (flushing) {
+                flushed.wait(lock);
+                continue;
+            }
+            flushing = true;
+            string batch;
+            batch.swap(buffer);
+            uint64_t upTo = appended;
+            lock.unlock();
+            bool written = true;
+            try {
+                writeAll(log, batch.data(), batch.size());
+                if (fdatasync(log) != 0) written = false;
+            } catch (const runtime_error &) {
+                written = false;
+            }
+            if (!written && ftruncate(log, logged) == 0 && lseek(log, logged, SEEK_SET) >= 0) fdatasync(log);
+            lock.lock();
+            flushing = false;
+            if (written) {
+                durable = upTo;
+                logged += (off_t) batch.size();
+            } else {
+                failed = true;
+            }
+            flushed.notify_all();
+            if (!written) throw runtime_error("DurableTree: could not write log");
+        }
+    }
+
+public:
+    /**
+     * Constructor with arguments. Loads snapshot and log if they exist.
+     * @param path path of files without extension
+     */
+    DurableTree(const string &path) : path(path), appended(0), durable(0), flushing(false), failed(false) {
+        loadSnapshot();
+        size_t valid = replayLog();
+        log = open((path + ".log").c_str(), O_WRONLY | O_CREAT, 0644);
+        if (log < 0) throw runtime_error("DurableTree: could not open " + path + ".log");
+        if (ftruncate(log, valid) != 0 || lseek(log, valid, SEEK_SET) < 0) {
+            close(log);
+            throw runtime_error("DurableTree: could not recover " + path + ".log");
+        }
+        logged = (off_t) valid;
+    }
+
+    /**
+     * Files are owned by one object, so it can not be copied
+     */
+    DurableTree(const DurableTree &) = delete;
+
+    /**
+     * Files are owned by one object, so it can not be copied
+     */
+    DurableTree &operator=(const DurableTree &) = delete;
+
+    /**
+     * Destructor, closes the log. Every mutation that returned is already on disk.
+     */
+    ~DurableTree() { close(log); }
+
+    /**
+     * Inserts node with given data and returns when the record is on disk, throws if it could not be written
+     * @param key key
+     * @param value value
+     */
+    void insert(const t1 &key, const t2 &value) {
+        string payload;
+        encode(payload, key);
+        encode(payload, value);
+        unique_lock<mutex> lock(guard);
+        checkFailed();
+        tree.insert(key, value);
+        frame(INSERT, payload);
+        commit(lock, ++appended);
+    }
+
+    /**
+     * Removes node with given key and returns when the record is on disk, throws if it could not be written
+     * @param key key
+     */
+    void remove(const t1 &key) {
+        string payload;
+        encode(payload, key);
+        unique_lock<mutex> lock(guard);
+        checkFailed();
+        tree.remove(key);
+        frame(REMOVE, payload);
+        commit(lock, ++appended);
+    }
+
+    /**
+     * Looks for value with given key
+     * @param key key
+     * @param value value found, left untouched if there is no such key
+     * @return true if key was found, false otherwise
+     */
+    bool get(const t1 &key, t2 &value) {
+        lock_guard<mutex> lock(guard);
+        auto *node = tree.searchKey(key);
+        if (node == nullptr) return false;
+        value = node->value;
+        return true;
+    }
+
+    /**
+     * Checks if tree has given key
+     * @param key key
+     * @return true if key was found, false otherwise
+     */
+    bool contains(const t1 &key) {
+        lock_guard<mutex> lock(guard);
+        return tree.searchKey(key) != nullptr;
+    }
+
+    /**
+     * Writes full snapshot of the tree and empties the log. Snapshot is written to a temporary file
+     * and renamed, so a crash leaves either old snapshot with its log or new snapshot. A crash between
+     * rename and emptying the log leaves new snapshot with old log, replaying it again gives the same
+     * tree because insert of an existing key is ignored and everything after a remove is replayed as it was.
+     * Directory is synced after rename, so the new snapshot survives a crash before the log is emptied.
+     */
+    void checkpoint() {
+        unique_lock<mutex> lock(guard);
+        checkFailed();
+        commit(lock, appended);
+        string image;
+        uint64_t count = 0;
+        encode(image, count);
+        for (auto it = tree.begin(); it != tree.end(); it++) {
+            encode(image, it->key);
+            encode(image, it->value);
+            count++;
+        }
+        memcpy(&image[0], &count, sizeof(count));
+
+        string temporary = path + ".snapshot.tmp";
+        int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) throw runtime_error("DurableTree: could not open " + temporary);
+        try {
+            writeAll(fd, image.data(), image.size());
+        } catch (const runtime_error &) {
+            close(fd);
+            throw;
+        }
+        if (fsync(fd) != 0) {
+            close(fd);
+            throw runtime_error("DurableTree: could not sync " + temporary);
+        }
+        close(fd);
+        if (rename(temporary.c_str(), (path + ".snapshot").c_str()) != 0)
+            throw runtime_error("DurableTree: could not replace snapshot");
+        syncDirectory();
+        if (ftruncate(log, 0) != 0 || lseek(log, 0, SEEK_SET) < 0 || fdatasync(log) != 0) {
+            failed = true;
+            throw runtime_error("DurableTree: could not reset log");
+        }
+        logged = 0;
+    }
+
+    /**
+     * Gives access to the tree. Caller has to make sure no mutation runs concurrently.
+     * @return tree
+     */
+    AVLTree<t1, t2> &getTree() { return tree; }
+};
+
+#endif //LAB_DURABLETREE_CPP
@@ -2,8 +2,32 @@
 // Created by Michał Nowaliński on 19.10.2018.
 //
 
+#ifndef LAB_LIST_CPP
+#define LAB_LIST_CPP
+
 #include <cstddef>
+#include <functional>
+#include <memory>
 #include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * Hash of a value used in fingerprints of lists, std::hash if type has it
+ * @tparam T type of value
+ * @param value value
+ * @return hash of value
+ */
+template<typename T>
+auto fingerprintOf(const T &value, int) -> decltype(std::hash<T>()(value)) { return std::hash<T>()(value); }
+
+/**
+ * Hash of a value of type without std::hash, all such values have the same hash
+ * @tparam T type of value
+ * @return 0
+ */
+template<typename T>
+size_t fingerprintOf(const T &, long) { return 0; }
 
 /**
  * Element of a list. Data structure used for holding data of type T.
@@ -41,7 +65,7 @@ struct Element {
      * @param info info
      * @param next pointer to next Element
      */
-    Element(a0 &&key, a0 &&info, Element *next) : key(std::move(key)), info(std::move(info)), next(next) {}
+    Element(a0 &&key, a1 &&info, Element *next) : key(std::move(key)), info(std::move(info)), next(next) {}
 
     /**
      * Return key
@@ -72,16 +96,106 @@ struct Element {
  * one node, called head, which has a pointer to another node, which
  * has a node to another node and so on. This allows list to have access
  * to each element.
+ * Elements are kept in chunks of CHUNK_SIZE contiguous elements, every chunk but the last one is
+ * full. Element with index i is element i % CHUNK_SIZE of chunk i / CHUNK_SIZE, so at() and operator[]
+ * cost O(1). Chunks never move their elements, so next pointers and references to elements stay valid
+ * until the list is cleared.
+ * Chunks are kept in a reference-counted store, copies of a list share it and copying costs O(1).
+ * The first change of a list whose store is shared, by push_back or non-const access to elements,
+ * copies the elements to a store of its own, clear just drops the shared store. A reference returned
+ * by non-const front, at or operator [] could change elements of later copies too, so once one was
+ * returned the store is not shared any more and copies copy elements, until the list is cleared.
+ * The list keeps an order-sensitive fingerprint of its elements, updated by push_back in O(1), so that
+ * lists of the same size can be told unequal without comparing elements. Non-const access to elements
+ * marks it out of date and it is recomputed when it is needed next.
  * @tparam a0 type of elements of the list
  */
 template<typename a0, typename a1>
 class MyRing {
 private:
+    /**
+     * number of elements in a chunk
+     */
+    static const size_t CHUNK_SIZE = 64;
+
+    /**
+     * Chunk directory. Every chunk has capacity CHUNK_SIZE reserved up front, so adding elements
+     * never reallocates it.
+     */
+    typedef std::vector<std::vector<Element<a0, a1>>> Chunks;
+
+    /**
+     * store of elements shared by copies of the list, nullptr if the list has never had elements
+     */
+    std::shared_ptr<Chunks> chunks;
+
+    /**
+     * false if non-const access returned a reference to an element, copies of the list then copy
+     * elements instead of sharing the store
+     */
+    bool shareable = true;
+
+    /**
+     * Makes the list the only owner of its store, copying elements if the store is shared
+     */
+    void unshare();
 
+    /**
+     * Makes the list have elements of that, sharing its store if that is shareable and copying the
+     * elements otherwise
+     * @param that list to be copied
+     */
+    void share(const MyRing<a0, a1> &that);
+
+    /**
+     * Returns element of given index, throws if there is no such element
+     * @param index number of element
+     * @return element of given index
+     */
+    Element<a0, a1> &locate(int index) const;
+
+    /**
+     * fingerprint of elements, valid only if fingerprinted is true
+     */
+    mutable size_t fingerprint = 0;
+
+    /**
+     * false if elements could have been changed through non-const access since fingerprint was computed
+     */
+    mutable bool fingerprinted = true;
+
+    /**
+     * number of changes other than adding elements to the end: clears, assignments and non-const accesses
+     */
+    size_t rewrites = 0;
+
+    /**
+     * Extends fingerprint by one element
+     * @param hash fingerprint of preceding elements
+     * @param element element
+     * @return fingerprint
+     */
+    static size_t extend(size_t hash, const Element<a0, a1> &element) {
+        size_t mixed = fingerprintOf(element.key, 0) * 31 + fingerprintOf(element.info, 0);
+        return (hash ^ mixed) * 1099511628211ull + 0x9e3779b97f4a7c15ull;
+    }
 
 public:
     /**
-     * Overwritten operator =
+     * Default constructor
+     */
+    MyRing() = default;
+
+    /**
+     * Copying constructor, the copy shares elements with that until one of them is changed. O(1), or O(n)
+     * if non-const access to that returned a reference since it was last cleared
+     * @param that list to be copied
+     */
+    MyRing(const MyRing<a0, a1> &that);
+
+    /**
+     * Overwritten operator =, the list shares elements with the assigned one until one of them is changed.
+     * O(1), or O(n) if non-const access to the assigned one returned a reference since it was last cleared
      * @return reference to the list
      */
     MyRing<a0, a1> &operator=(const MyRing<a0, a1> &);
@@ -99,10 +213,24 @@ public:
     void push_back(a0 key, a1 info);
 
     /**
-     * Clears the list destroying all its elements
+     * Clears the list, its elements are destroyed unless copies of the list still share them
      */
     void clear();
 
+    /**
+     * Returns order-sensitive fingerprint of elements. Equal lists have equal fingerprints, as long as
+     * std::hash of key and info agrees with their operator ==. O(1), or O(n) after non-const access.
+     * @return fingerprint
+     */
+    size_t getFingerprint() const;
+
+    /**
+     * Returns number of changes other than adding elements to the end, so that whoever checked elements
+     * can tell if checking only the elements added since then is enough
+     * @return number of clears, assignments and non-const accesses since the list was created
+     */
+    size_t getRewrites() const { return rewrites; }
+
     /**
      * Returns lists's size
      * @return list's size
@@ -160,7 +288,8 @@ public:
      */
     size_t elements = 0;
     /**
-     * Pointer to first element of the list
+     * Pointer to first element of the list. Elements may be shared with copies of the list, so they
+     * must not be changed through head and tail, only through non-const front, at and operator [].
      */
     Element<a0, a1> *head = nullptr;
     /**
@@ -169,36 +298,66 @@ public:
     Element<a0, a1> *tail = nullptr;
 };
 
+template<typename a0, typename a1>
+MyRing<a0, a1>::MyRing(const MyRing<a0, a1> &that) : rewrites(that.rewrites) {
+    share(that);
+}
+
 template<typename a0, typename a1>
 MyRing<a0, a1> &MyRing<a0, a1>::operator=(const MyRing<a0, a1> &that) {
     if (this == &that)
         return *this;
-    Element<a0, a1> *tmp;
-    while (head) {
-        tmp = head;
-        head = head->next;
-        delete tmp;
-    }
-    elements = that.elements;
-    head = that.head;
-    tail = that.tail;
+    share(that);
+    ++rewrites;
+    return *this;
 }
 
 template<typename a0, typename a1>
-MyRing<a0, a1>::~MyRing() {
-    Element<a0, a1> *tmp;
-    while (head) {
-        tmp = head;
-        head = head->next;
-        delete tmp;
+void MyRing<a0, a1>::share(const MyRing<a0, a1> &that) {
+    if (that.shareable) {
+        chunks = that.chunks;
+        elements = that.elements;
+        head = that.head;
+        tail = that.tail;
+    } else {
+        chunks.reset();
+        head = tail = nullptr;
+        elements = 0;
+        const Element<a0, a1> *curr = that.head;
+        for (size_t i = 0; i < that.elements; i++, curr = curr->next) push_back(curr->key, curr->info);
     }
+    shareable = true;
+    fingerprint = that.fingerprint;
+    fingerprinted = that.fingerprinted;
 }
 
+template<typename a0, typename a1>
+void MyRing<a0, a1>::unshare() {
+    if (!chunks || chunks.use_count() == 1)
+        return;
+    std::shared_ptr<Chunks> shared = std::move(chunks);
+    Element<a0, a1> *curr = head;
+    size_t count = elements, kept = fingerprint;
+    bool keptValid = fingerprinted;
+    head = tail = nullptr;
+    elements = 0;
+    for (size_t i = 0; i < count; i++, curr = curr->next) push_back(curr->key, curr->info);
+    fingerprint = kept;
+    fingerprinted = keptValid;
+}
+
+template<typename a0, typename a1>
+MyRing<a0, a1>::~MyRing() {}
+
 
 template<typename a0, typename a1>
 Element<a0, a1> &MyRing<a0, a1>::front() {
     if (head == nullptr)
         throw std::runtime_error("MyRing is empty ...");
+    unshare();
+    shareable = false;
+    fingerprinted = false;
+    ++rewrites;
     return *head;
 }
 
@@ -211,7 +370,17 @@ Element<a0, a1> const &MyRing<a0, a1>::front() const {
 
 template<typename a0, typename a1>
 void MyRing<a0, a1>::push_back(a0 key, a1 info) {
-    auto *newNode = new Element<a0, a1>(key, info, nullptr);
+    unshare();
+    if (!chunks)
+        chunks = std::make_shared<Chunks>();
+    if (chunks->empty() || chunks->back().size() == CHUNK_SIZE) {
+        chunks->emplace_back();
+        chunks->back().reserve(CHUNK_SIZE);
+    }
+    chunks->back().emplace_back(std::move(key), std::move(info), nullptr);
+    auto *newNode = &chunks->back().back();
+    if (fingerprinted)
+        fingerprint = extend(fingerprint, *newNode);
     if (head == nullptr)
         head = newNode;
     if (tail != nullptr)
@@ -228,64 +397,58 @@ template<typename a0, typename a1>
 size_t MyRing<a0, a1>::size() const { return elements; }
 
 template<typename a0, typename a1>
-Element<a0, a1> &MyRing<a0, a1>::operator[](int const index) {
-    int cont = 0;
-    Element<a0, a1> *curr = head;
-    while (curr) {
-        if (cont == index)
-            return curr->key;
-        curr = curr->next;
-        ++cont;
+size_t MyRing<a0, a1>::getFingerprint() const {
+    if (!fingerprinted) {
+        fingerprint = 0;
+        Element<a0, a1> *curr = head;
+        for (size_t i = 0; i < elements; i++, curr = curr->next)
+            fingerprint = extend(fingerprint, *curr);
+        fingerprinted = true;
     }
-    return nullptr;
+    return fingerprint;
 }
 
 template<typename a0, typename a1>
-Element<a0, a1> const &MyRing<a0, a1>::operator[](int const index) const {
-    int cont = 0;
-    Element<a0, a1> *curr = head;
-    while (curr) {
-        if (cont == index)
-            return curr->key;
-        curr = curr->next;
-        ++cont;
-    }
-    return nullptr;
+Element<a0, a1> &MyRing<a0, a1>::locate(int const index) const {
+    if (index < 0 || (size_t) index >= elements)
+        throw std::out_of_range("MyRing index out of range");
+    return const_cast<Element<a0, a1> &>((*chunks)[index / CHUNK_SIZE][index % CHUNK_SIZE]);
 }
 
 template<typename a0, typename a1>
-Element<a0, a1> &MyRing<a0, a1>::at(int const index) {
-    int cont = 0;
-    Element<a0, a1> *curr = head;
-    while (curr) {
-        if (cont == index)
-            return *curr;
-        curr = curr->next;
-        cont++;
-    }
+Element<a0, a1> &MyRing<a0, a1>::operator[](int const index) {
+    unshare();
+    shareable = false;
+    fingerprinted = false;
+    ++rewrites;
+    return locate(index);
 }
 
 template<typename a0, typename a1>
-Element<a0, a1> const &MyRing<a0, a1>::at(int const index) const {
-    int cont = 0;
-    Element<a0, a1> *curr = head;
-    while (curr) {
-        if (cont == index)
-            return curr->key;
-        curr = curr->next;
-        cont++;
-    }
+Element<a0, a1> const &MyRing<a0, a1>::operator[](int const index) const { return locate(index); }
+
+template<typename a0, typename a1>
+Element<a0, a1> &MyRing<a0, a1>::at(int const index) {
+    unshare();
+    shareable = false;
+    fingerprinted = false;
+    ++rewrites;
+    return locate(index);
 }
 
+template<typename a0, typename a1>
+Element<a0, a1> const &MyRing<a0, a1>::at(int const index) const { return locate(index); }
+
 
 template<typename a0, typename a1>
 void MyRing<a0, a1>::clear() {
-    Element<a0, a1> *curr;
-    while (head) {
-        curr = head;
-        head = head->next;
-        delete curr;
-    }
+    chunks.reset();
     head = tail = nullptr;
     elements = 0;
-}
\ No newline at end of file
+    fingerprint = 0;
+    fingerprinted = true;
+    shareable = true;
+    ++rewrites;
+}
+
+#endif //LAB_LIST_CPP
@@ -0,0 +1,598 @@
+#ifndef LAB_MAPPEDRING_CPP
+#define LAB_MAPPEDRING_CPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * Ring of fixed capacity kept in a memory-mapped file, it holds the last capacity elements added and
+ * survives restarts. The file starts with a header page holding head, tail and generation, followed by
+ * a circular array of fixed-size records. Element number p (counted from creation of the file) is kept
+ * in record p % capacity, so adding an element writes key and info straight into the mapping, without
+ * serialising or copying them to a buffer.
+ *
+ * Pages are flushed with msync: every syncEvery additions, on sync() and in destructor. Dirty pages may
+ * also reach the disk earlier and in any order, so every record carries its element number and a
+ * checksum, and the header keeps, apart from the live tail, the tail at the last finished sync, which
+ * is stored only after records are flushed. After a crash the constructor starts from that tail and
+ * goes forward while records are valid, so the ring holds a gap-free sequence of whole records that
+ * were added, and every record added before the last finished sync() is among them.
+ * @tparam t1 type of key, trivially copyable
+ * @tparam t2 type of info, trivially copyable
+ */
+template<typename t1, typename t2>
+class MappedRing {
+    static_assert(is_trivially_copyable<t1>::value && is_trivially_copyable<t2>::value,
+                  "MappedRing supports trivially copyable types");
+
+    /**
+     * Structure that holds an element of the ring in the file
+     */
+    struct Element {
+        /**
+         * number of the element + 1, 0 for record that was never written
+         */
+        uint64_t sequence;
+        /**
+         * checksum of sequence, key and info
+         */
+        uint32_t checksum;
+        /**
+         * key
+         */
+        t1 key;
+        /**
+         * info
+         */
+        t2 info;
+
+        /**
+         * Friend function used to printing iterator using cout
+         * @param output
+         * @param show
+         * @return ostream
+         */
+        friend ostream &operator<<(ostream &output, const Element &show) {
+            output << show.key << " " << show.info << endl;
+            return output;
+        }
+    };
+
+    /**
+     * Header of the file
+     */
+    struct Header {
+        /**
+         * identifies file format
+         */
+        char magic[8];
+        /**
+         * size of record, file can be opened only with the same key and info types
+         */
+        uint64_t recordSize;
+        /**
+         * number of records
+         */
+        uint64_t capacity;
+        /**
+         * number of the first element in the ring, unless it was overwritten. It changes only on clear()
+         */
+        uint64_t head;
+        /**
+         * number of elements added since creation of the file
+         */
+        uint64_t tail;
+        /**
+         * tail at the last finished sync, records before it are on disk
+         */
+        uint64_t synced;
+        /**
+         * number of times the file was opened
+         */
+        uint64_t generation;
+    };
+
+    /**
+     * descriptor of the file
+     */
+    int file;
+
+    /**
+     * whole mapping, header page followed by records
+     */
+    char *mapping;
+
+    /**
+     * size of the mapping
+     */
+    size_t length;
+
+    /**
+     * size of a page, records start one page after the header
+     */
+    size_t page;
+
+    /**
+     * header in the mapping
+     */
+    Header *header;
+
+    /**
+     * records in the mapping
+     */
+    Element *records;
+
+    /**
+     * number of records
+     */
+    uint64_t capacity;
+
+    /**
+     * number of elements added since the last sync
+     */
+    size_t unsynced;
+
+    /**
+     * number of additions after which sync is called, 0 if only explicit sync() flushes
+     */
+    size_t syncEvery;
+
+    /**
+     * FNV-1a checksum of given bytes, continued from hash
+     * @param data bytes
+     * @param size number of bytes
+     * @param hash checksum of preceding bytes
+     * @return checksum
+     */
+    static uint32_t checksum(const void *data, size_t size, uint32_t hash = 2166136261u) {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    /**
+     * Computes checksum of a record
+     * @param element record
+     * @return checksum
+     */
+    static uint32_t checksum(const Element &element) {
+        uint32_t hash = checksum(&element.sequence, sizeof(element.sequence));
+        hash = checksum(&element.key, sizeof(element.key), hash);
+        return checksum(&element.info, sizeof(element.info), hash);
+    }
+
+    /**
+     * Checks if element with given number is in its record
+     * @param position number of element
+     * @return true if record holds that element and its checksum matches
+     */
+    bool valid(uint64_t position) const {
+        const Element &element = records[position % capacity];
+        return element.sequence == position + 1 && element.checksum == checksum(element);
+    }
+
+    /**
+     * Returns element at logical position
+     * @param index position counted from the first element, less than size()
+     * @return element
+     */
+    const Element &slot(size_t index) const { return records[(first() + index) % capacity]; }
+
+    /**
+     * Returns number of the first element in the ring
+     * @return number of the first element
+     */
+    uint64_t first() const {
+        uint64_t tail = header->tail;
+        return tail - header->head > capacity ? tail - capacity : header->head;
+    }
+
+    /**
+     * Flushes given part of the mapping
+     * @param from first byte
+     * @param size number of bytes
+     */
+    void flush(const char *from, size_t size) {
+        if (size == 0) return;
+        size_t begin = (from - mapping) / page * page;
+        if (msync(mapping + begin, from + size - (mapping + begin), MS_SYNC) != 0)
+            throw runtime_error("MappedRing: msync failed");
+    }
+
+    /**
+     * Finds head and tail after the file was opened. Tail is moved from the last synced one forward over
+     * valid records, head is moved back from tail over valid records, but not behind head of the header.
+     * Records of elements behind tail, written before the crash but cut off by a torn record, are erased,
+     * so that later recoveries do not take them for new elements.
+     */
+    void recover() {
+        uint64_t tail = header->synced;
+        while (valid(tail)) tail++;
+        uint64_t head = tail - header->head > capacity ? tail - capacity : header->head;
+        uint64_t begin = tail;
+        while (begin > head && valid(begin - 1)) begin--;
+        bool erased = false;
+        for (uint64_t i = 0; i < capacity; i++) {
+            if (records[i].sequence > tail) {
+                records[i].sequence = 0;
+                erased = true;
+            }
+        }
+        if (erased) flush((char *) records, capacity * sizeof(Element));
+        header->head = begin;
+        header->tail = tail;
+        header->generation++;
+        sync();
+    }
+
+public:
+    /**
+     * Class object that iterates throughout full ring. It keeps logical position of the element,
+     * so moving it by any number of positions costs O(1). Elements are read-only, as changing them
+     * in place would not update their checksums.
+     * @tparam K key
+     * @tparam I info
+     */
+    template<typename K, typename I>
+    class Iterator {
+        /**
+         * iterated ring, nullptr for iterator that does not point to any element
+         */
+        const MappedRing *ring;
+        /**
+         * logical position in the ring
+         */
+        size_t index;
+    public:
+        /**
+         * Default constructor
+         */
+        Iterator() : ring(nullptr), index(0) {}
+
+        /**
+         * Constructor with ring and position iterator points to
+         * @param ring ring
+         * @param index position in the ring
+         */
+        Iterator(const MappedRing *ring, size_t index) : ring(ring && ring->size() ? ring : nullptr), index(index) {}
+
+        /**
+         * Overwritten operator +. It moves iterator by length position forwards
+         * @param length number by which iterator is moved forwards
+         * @return iterator
+         */
+        Iterator operator+(int length) {
+            if (ring && length > 0) index = (index + length % ring->size()) % ring->size();
+            return *this;
+        }
+
+        /**
+         * Overwritten operator +. It moves iterator by length position backword
+         * @param length number by which iterator is moved backword
+         * @return iterator
+         */
+        Iterator operator-(int length) {
+            if (ring && length > 0) index = (index + ring->size() - length % ring->size()) % ring->size();
+            return *this;
+        }
+
+        /**
+         * Overwritten operator ++. Moves forward by one
+         * @return iterator
+         */
+        Iterator &operator++() {
+            if (ring && ++index == ring->size()) index = 0;
+            return *this;
+        }
+
+        /**
+         * Overwritten operator ++. Moves forward by one
+         * @return iterator before moving
+         */
+        Iterator operator++(int) {
+            Iterator temporary(*this);
+            ++*this;
+            return temporary;
+        }
+
+        /**
+         * Overwritten operator --. Moves backword by one
+         * @return iterator
+         */
+        Iterator &operator--() {
+            if (ring) index = (index ? index : ring->size()) - 1;
+            return *this;
+        }
+
+        /**
+         * Overwritten operator --. Moves backword by one
+         * @return iterator before moving
+         */
+        Iterator operator--(int) {
+            Iterator temporary(*this);
+            --*this;
+            return temporary;
+        }
+
+        /**
+         * Overwritten operator ==, compares to iterators
+         * @param iterator iterator to be compared
+         * @return true if iterators point to same object, false otherwise
+         */
+        bool operator==(Iterator iterator) const { return ring == iterator.ring && index == iterator.index; }
+
+        /**
+         * Overwritten operator ==, compares to iterators
+         * @param iterator iterator to be compared
+         * @return false if iterators point to same object, true otherwise
+         */
+        bool operator!=(Iterator iterator) const { return !(*this == iterator); }
+
+        /**
+         * Overwritten operator *, return object via accessing pointer
+         * @return iterator object
+         */
+        const Element &operator*() const { return ring->slot(index); }
+
+        /**
+         * Overwritten operator->. Used to access iterator pointer
+         * @return iterator pointer
+         */
+        const Element *operator->() const { return &ring->slot(index); }
+
+        /**
+         * returns key
+         * @return key
+         */
+        t1 getKey() { return ring->slot(index).key; }
+
+        /**
+         * returns info
+         * @return info
+         */
+        t2 getInfo() { return ring->slot(index).info; }
+
+        /**
+         * Friend function used to printing ring using cout
+         * @param output output
+         * @param iter iterator
+         * @return ostream
+         */
+        friend ostream &operator<<(ostream &output, const Iterator &iter) {
+            output << *iter;
+            return output;
+        }
+    };
+
+    typedef Iterator<t1, t2> RingIterator;
+    typedef Iterator<const t1, const t2> ConstRingIterator;
+
+    /**
+     * Constructor with arguments. Creates the file if it does not exist, otherwise maps it and recovers
+     * elements that were in the ring.
+     * @param path path of the file
+     * @param capacity number of elements kept, used only when the file is created
+     * @param syncEvery number of additions after which pages are flushed, 0 to flush only on sync()
+     */
+    MappedRing(const string &path, size_t capacity, size_t syncEvery = 0)
+            : unsynced(0), syncEvery(syncEvery) {
+        if (capacity == 0) throw std::invalid_argument("Ring capacity has to be greater than 0");
+        page = (size_t) sysconf(_SC_PAGESIZE);
+        file = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (file < 0) throw runtime_error("MappedRing: could not open " + path);
+        struct stat status;
+        if (fstat(file, &status) != 0) {
+            close(file);
+            throw runtime_error("MappedRing: could not stat " + path);
+        }
+        bool created = status.st_size == 0;
+        if (!created) {
+            Header existing;
+            if (pread(file, &existing, sizeof(existing), 0) != (ssize_t) sizeof(existing) ||
+                memcmp(existing.magic, "LABRING1", 8) != 0 || existing.recordSize != sizeof(Element) ||
+                existing.capacity == 0 || existing.head > existing.synced ||
+                (size_t) status.st_size != page + existing.capacity * sizeof(Element)) {
+                close(file);
+                throw runtime_error("MappedRing: " + path + " is not a ring of this type");
+            }
+            capacity = existing.capacity;
+        }
+        this->capacity = capacity;
+        length = page + capacity * sizeof(Element);
+        if (created && ftruncate(file, length) != 0) {
+            close(file);
+            throw runtime_error("MappedRing: could not resize " + path);
+        }
+        void *address = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+        if (address == MAP_FAILED) {
+            close(file);
+            throw runtime_error("MappedRing: could not map " + path);
+        }
+        mapping = static_cast<char *>(address);
+        header = reinterpret_cast<Header *>(mapping);
+        records = reinterpret_cast<Element *>(mapping + page);
+        if (created) {
+            memcpy(header->magic, "LABRING1", 8);
+            header->recordSize = sizeof(Element);
+            header->capacity = capacity;
+            header->head = header->tail = header->synced = header->generation = 0;
+        }
+        recover();
+    }
+
+    /**
+     * File is owned by one object, so it can not be copied
+     */
+    MappedRing(const MappedRing &) = delete;
+
+    /**
+     * File is owned by one object, so it can not be copied
+     */
+    MappedRing &operator=(const MappedRing &) = delete;
+
+    /**
+     * Destructor, flushes the ring and unmaps the file
+     */
+    ~MappedRing() {
+        try {
+            sync();
+        } catch (const runtime_error &) {
+        }
+        munmap(mapping, length);
+        close(file);
+    }
+
+    /**
+     * adds key and value to the ring at end, if ring is full the first element is overwritten
+     * @param key key to be added
+     * @param info infor to be added
+     */
+    void addEnd(const t1 &key, const t2 &info) {
+        uint64_t position = header->tail;
+        Element &adder = records[position % capacity];
+        adder.sequence = position + 1;
+        adder.key = key;
+        adder.info = info;
+        adder.checksum = checksum(adder);
+        header->tail = position + 1;
+        if (syncEvery && ++unsynced >= syncEvery) sync();
+    }
+
+    /**
+     * Flushes records added since the last sync and then the header. When it returns, elements
+     * added so far survive a crash.
+     */
+    void sync() {
+        uint64_t tail = header->tail, syncedTail = header->synced;
+        if (tail - syncedTail >= capacity) {
+            flush((char *) records, capacity * sizeof(Element));
+        } else if (tail != syncedTail) {
+            size_t first = syncedTail % capacity, last = tail % capacity;
+            if (first < last) {
+                flush((char *) (records + first), (last - first) * sizeof(Element));
+            } else {
+                flush((char *) (records + first), (capacity - first) * sizeof(Element));
+                flush((char *) records, last * sizeof(Element));
+            }
+        }
+        header->synced = tail;
+        flush(mapping, sizeof(Header));
+        unsynced = 0;
+    }
+
+    /**
+     * Removes all elements, file keeps its size
+     */
+    void clear() {
+        sync();
+        header->head = header->tail;
+        flush(mapping, sizeof(Header));
+    }
+
+    /**
+     * returns iterator to begin
+     * @return begin iterator
+     */
+    RingIterator begin() const { return RingIterator(this, 0); }
+
+    /**
+     * returns iterator to end
+     * @return end interator
+     */
+    RingIterator end() const { return RingIterator(this, 0); }
+
+    /**
+     * returns iterator to last element
+     * @return iterator to last element
+     */
+    RingIterator last() const { return RingIterator(this, size() ? size() - 1 : 0); }
+
+    /**
+     * Searches for iterator with given value
+     * @param value value
+     * @return iterator with given value
+     */
+    RingIterator find(const t1 &value) const {
+        for (size_t i = 0; i < size(); i++) if (slot(i).key == value) return RingIterator(this, i);
+        return RingIterator();
+    }
+
+    /**
+     * returns iterator pointing to the first element
+     * @return iterator pointing to the first element
+     */
+    ConstRingIterator constBegin() const { return ConstRingIterator(this, 0); }
+
+    /**
+     * returns iterator pointing to the last element
+     * @return iterator pointing to the last element
+     */
+    ConstRingIterator constEnd() const { return ConstRingIterator(this, 0); }
+
+    /**
+     * returns last iterator
+     * @return last iterator
+     */
+    ConstRingIterator constLast() const { return ConstRingIterator(this, size() ? size() - 1 : 0); }
+
+    /**
+     * Look for iterator with given value
+     * @param value value
+     * @return iterator with given value
+     */
+    ConstRingIterator constFind(const t1 &value) const {
+        for (size_t i = 0; i < size(); i++) if (slot(i).key == value) return ConstRingIterator(this, i);
+        return ConstRingIterator();
+    }
+
+    /**
+     * Returns number of elements
+     * @return number of elements
+     */
+    size_t size() const { return header->tail - first(); }
+
+    /**
+     * Returns maximal number of elements
+     * @return maximal number of elements
+     */
+    size_t getCapacity() const { return capacity; }
+
+    /**
+     * Returns number of times the file was opened, including this time
+     * @return generation
+     */
+    uint64_t getGeneration() const { return header->generation; }
+
+    /**
+     * Returns true is ring is not empty, false if it is
+     * @return true is ring is not empty, false if it is
+     */
+    bool isEmpty() const { return size() == 0; }
+
+    /**
+     * Friend function used to printing ring using cout
+     * @param output output
+     * @param ring ring
+     * @return ostream
+     */
+    friend ostream &operator<<(ostream &output, const MappedRing &ring) {
+        for (size_t i = 0; i < ring.size(); i++) output << ring.slot(i).key << " " << ring.slot(i).info << endl;
+        return output;
+    }
+};
+
+#endif //LAB_MAPPEDRING_CPP
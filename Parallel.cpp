@@ -0,0 +1,106 @@
+#ifndef LAB_PARALLEL_CPP
+#define LAB_PARALLEL_CPP
+
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+#include "Ring.cpp"
+#include "ArrayRing.cpp"
+
+using namespace std;
+
+/**
+ * Returns number of threads used by parallel algorithms
+ * @param threads requested number of threads, 0 for number of hardware threads
+ * @return number of threads, at least 1
+ */
+inline size_t parallelThreads(size_t threads) {
+    if (threads == 0) threads = thread::hardware_concurrency();
+    return threads == 0 ? 1 : threads;
+}
+
+/**
+ * Runs task for every segment, each segment on its own thread, the first one on the calling thread.
+ * If any task throws, the first exception, counting segments in order, is rethrown after all threads finish.
+ * @tparam Segment type of segment
+ * @tparam Task callable with (const Segment &, size_t number of segment)
+ * @param segments segments
+ * @param task task
+ */
+template<typename Segment, typename Task>
+void runSegments(const vector<Segment> &segments, Task task) {
+    vector<exception_ptr> errors(segments.size());
+    vector<thread> workers;
+    workers.reserve(segments.size());
+    auto guarded = [&](size_t i) {
+        try {
+            task(segments[i], i);
+        } catch (...) {
+            errors[i] = current_exception();
+        }
+    };
+    for (size_t i = 1; i < segments.size(); i++) workers.emplace_back(guarded, i);
+    if (!segments.empty()) guarded(0);
+    for (thread &worker : workers) worker.join();
+    for (const exception_ptr &error : errors) if (error) rethrow_exception(error);
+}
+
+/**
+ * Calls function for every element of the ring. Ring is cut into one segment per thread and segments
+ * are processed concurrently, so function must be safe to call from many threads at once for different
+ * elements. Ring must not be changed while it runs, except for infos of elements by the function. It takes
+ * the ring as non-const, as infos are changed, and may leave skip markers in it for later scans.
+ * @tparam t1 key
+ * @tparam t2 info
+ * @tparam S storage policy
+ * @tparam Function callable with (const t1 &key, t2 &info)
+ * @param ring ring
+ * @param function function
+ * @param threads number of threads, 0 for number of hardware threads
+ */
+template<typename t1, typename t2, typename S, typename Function>
+void parallelForEach(Ring<t1, t2, S> &ring, Function function, size_t threads = 0) {
+    typedef typename Ring<t1, t2, S>::Segment Segment;
+    runSegments(ring.segments(parallelThreads(threads)), [&](const Segment &segment, size_t) {
+        auto it = segment.first;
+        for (size_t i = 0; i < segment.length; i++, ++it) function(it->key, it->info);
+    });
+}
+
+/**
+ * Maps every element of the ring and combines the results. Each thread folds its segment starting from
+ * identity, then partial results are combined in order of segments, so for associative combine the
+ * result is the same as of sequential fold over the ring from head. Ring is only read, so many reductions
+ * may run over the same ring at once, but it must not be changed while they run.
+ * @tparam t1 key
+ * @tparam t2 info
+ * @tparam S storage policy
+ * @tparam Result type of result
+ * @tparam Map callable with (const t1 &key, const t2 &info) returning Result
+ * @tparam Combine callable with (const Result &, const Result &) returning Result
+ * @param ring ring
+ * @param identity neutral element of combine
+ * @param map function applied to every element
+ * @param combine associative function merging results
+ * @param threads number of threads, 0 for number of hardware threads
+ * @return combined result, identity if ring is empty
+ */
+template<typename t1, typename t2, typename S, typename Result, typename Map, typename Combine>
+Result parallelReduce(const Ring<t1, t2, S> &ring, const Result &identity, Map map, Combine combine,
+                      size_t threads = 0) {
+    typedef typename Ring<t1, t2, S>::ConstSegment Segment;
+    vector<Segment> segments = ring.segments(parallelThreads(threads));
+    vector<Result> partial(segments.size(), identity);
+    runSegments(segments, [&](const Segment &segment, size_t number) {
+        Result local = identity;
+        auto it = segment.first;
+        for (size_t i = 0; i < segment.length; i++, ++it) local = combine(local, map(it->key, it->info));
+        partial[number] = std::move(local);
+    });
+    Result result = identity;
+    for (const Result &part : partial) result = combine(result, part);
+    return result;
+}
+
+#endif //LAB_PARALLEL_CPP
@@ -0,0 +1,381 @@
+#ifndef LAB_PRODUCE_CPP
+#define LAB_PRODUCE_CPP
+
+#include <algorithm>
+#include <cstddef>
+#include "Ring.cpp"
+#include "ArrayRing.cpp"
+
+using namespace std;
+
+/**
+ * Algorithm produces new Ring object based on two rings provided. It lookups the 1st and 2nd ring
+ * in the way that it starts from star1 and start2 positions respectively, and gathers data. Lookup is
+ * performed via iterators. It copies steps1 elements from the first ring and adds it in new ring, then
+ * it copies steps2 elements form the second. Elements pointed by iterators are added in new ring.
+ * Algorithm does that times times. If clockwise is set to false, then iterators are moved backwards
+ * instead of forward.
+ * @tparam K type of key
+ * @tparam T type of info
+ * @tparam S storage policy of rings
+ * @param ring1 first ring
+ * @param start1 position from which algorithm start gathering data from 1st ring
+ * @param steps1 how many elements are skipped every gathering in first ring
+ * @param ring2 second ring
+ * @param start2 position form which algorithm start gathering data from 2nd ring
+ * @param steps2 how many elements are skipped every gathering in second ring
+ * @param times how many times the algorithm shall run
+ * @param clockwise if true algorithm lookups through ring clockwise, if false counterclockwise
+ * @return Ring object created on basis of running algorithm, returned by move
+ */
+template<typename K, typename T, typename S>
+Ring<K, T, S>
+produce(const Ring<K, T, S> &ring1, int start1, int steps1, const Ring<K, T, S> &ring2, int start2, int steps2,
+        int times, bool clockwise1, bool clockwise2, bool begin) {
+    Ring<K, T, S> ring;
+    if (ring1.isEmpty() || ring2.isEmpty()) return ring;
+    typename Ring<K, T, S>::ConstRingIterator it1 = ring1.constBegin();
+    typename Ring<K, T, S>::ConstRingIterator it2 = ring2.constBegin();
+
+    it1 + start1;
+    it2 + start2;
+    int i = 0;
+    while (i != times) {
+        for (int j = 0; j < steps1; j++) {
+            if (begin) ring.addBegin(it1.getKey(), it1.getInfo());
+            else ring.addEnd(it1.getKey(), it1.getInfo());
+            if (clockwise1) it1++;
+            else it1--;
+        }
+        for (int j = 0; j < steps2; j++) {
+            if (begin) ring.addBegin(it2.getKey(), it2.getInfo());
+            else ring.addEnd(it2.getKey(), it2.getInfo());
+            if (clockwise2) it2++;
+            else it2--;
+        }
+        i++;
+    }
+
+    return ring;
+}
+
+/**
+ * produce() for rings with ArrayStorage or InlineStorage. Result has the same elements in the same order, but instead
+ * of adding elements one by one, size of the result is computed up front and reserved once, and every
+ * run of steps elements taken from one ring is appended as block copies computed by modular index
+ * arithmetic (see Ring::appendRun). With begin set the result is the first generated element followed
+ * by the others in reverse order, so runs are visited from the last one and copied in opposite direction.
+ * @tparam K type of key
+ * @tparam T type of info
+ * @tparam N inline capacity of rings
+ * @return Ring object created on basis of running algorithm, returned by move
+ */
+template<typename K, typename T, size_t N>
+Ring<K, T, InlineStorage<N>>
+produce(const Ring<K, T, InlineStorage<N>> &ring1, int start1, int steps1, const Ring<K, T, InlineStorage<N>> &ring2,
+        int start2, int steps2, int times, bool clockwise1, bool clockwise2, bool begin) {
+    Ring<K, T, InlineStorage<N>> ring;
+    if (ring1.isEmpty() || ring2.isEmpty() || times <= 0) return ring;
+    size_t size1 = ring1.size(), size2 = ring2.size();
+    size_t run1 = max(steps1, 0), run2 = max(steps2, 0);
+    size_t first1 = start1 > 0 ? start1 % size1 : 0, first2 = start2 > 0 ? start2 % size2 : 0;
+    ring.reserve((size_t) times * (run1 + run2));
+
+    // logical position in ring of element taken as taken-th one from it
+    auto position = [](size_t first, size_t taken, size_t size, bool clockwise) {
+        taken %= size;
+        return clockwise ? (first + taken) % size : (first + size - taken) % size;
+    };
+
+    if (!begin) {
+        for (int i = 0; i < times; i++) {
+            ring.appendRun(ring1, position(first1, i * run1, size1, clockwise1), run1, clockwise1);
+            ring.appendRun(ring2, position(first2, i * run2, size2, clockwise2), run2, clockwise2);
+        }
+        return ring;
+    }
+
+    // first generated element stays first, it is skipped when its run is copied in reverse
+    bool fromFirst = run1 > 0;
+    if (fromFirst) ring.appendRun(ring1, first1, 1, clockwise1);
+    else if (run2 > 0) ring.appendRun(ring2, first2, 1, clockwise2);
+    for (int i = times - 1; i >= 0; i--) {
+        size_t skip2 = i == 0 && !fromFirst ? 1 : 0;
+        if (run2 > skip2)
+            ring.appendRun(ring2, position(first2, i * run2 + run2 - 1, size2, clockwise2), run2 - skip2,
+                           !clockwise2);
+        size_t skip1 = i == 0 && fromFirst ? 1 : 0;
+        if (run1 > skip1)
+            ring.appendRun(ring1, position(first1, i * run1 + run1 - 1, size1, clockwise1), run1 - skip1,
+                           !clockwise1);
+    }
+    return ring;
+}
+
+/**
+ * Lazy counterpart of produce(). It does not own nor copy the rings, it keeps only references to them
+ * and parameters of the algorithm, and generates elements one by one while it is iterated, in the same
+ * order in which they would appear in the ring returned by produce() with the same arguments. Nothing
+ * is allocated. Rings must outlive the view and must not be modified while it is used.
+ * @tparam K type of key
+ * @tparam T type of info
+ * @tparam S storage policy of rings
+ */
+template<typename K, typename T, typename S>
+class ProduceView {
+    typedef typename Ring<K, T, S>::ConstRingIterator RingIterator;
+
+    /**
+     * first ring
+     */
+    const Ring<K, T, S> *ring1;
+    /**
+     * second ring
+     */
+    const Ring<K, T, S> *ring2;
+    /**
+     * parameters of produce(), negative steps and times are treated as 0
+     */
+    int start1, steps1, start2, steps2, times;
+    /**
+     * directions of lookup and placement of elements
+     */
+    bool clockwise1, clockwise2, atBegin;
+
+    /**
+     * Returns iterator of a ring moved by given number of positions from start
+     * @param ring ring
+     * @param start start position, as in produce()
+     * @param steps number of positions to move
+     * @param clockwise direction of moving
+     * @return iterator
+     */
+    static RingIterator locate(const Ring<K, T, S> &ring, int start, size_t steps, bool clockwise) {
+        RingIterator it = ring.constBegin();
+        it + start;
+        size_t size = ring.size();
+        int length = (int) (steps % size);
+        if (clockwise) it + length;
+        else it - length;
+        return it;
+    }
+
+public:
+    /**
+     * Iterator over generated elements. Generated element number g (counted as produce() generates
+     * them) is taken from ring1 if g % (steps1 + steps2) < steps1, from ring2 otherwise. Iterator keeps
+     * positions in both rings and moves one of them per step.
+     */
+    class Iterator {
+        friend class ProduceView;
+
+        /**
+         * iterated view
+         */
+        const ProduceView *view;
+        /**
+         * position in the view
+         */
+        size_t position;
+        /**
+         * number of generated element iterator points to
+         */
+        size_t generated;
+        /**
+         * generated % (steps1 + steps2)
+         */
+        size_t offset;
+        /**
+         * position in first ring, element to be taken from it next
+         */
+        RingIterator it1;
+        /**
+         * position in second ring, element to be taken from it next
+         */
+        RingIterator it2;
+
+        /**
+         * Moves to the next generated element
+         */
+        void forward() {
+            if (offset < (size_t) view->steps1) {
+                if (view->clockwise1) it1++;
+                else it1--;
+            } else {
+                if (view->clockwise2) it2++;
+                else it2--;
+            }
+            generated++;
+            if (++offset == view->round()) offset = 0;
+        }
+
+        /**
+         * Moves to the previous generated element
+         */
+        void backward() {
+            offset = (offset ? offset : view->round()) - 1;
+            generated--;
+            if (offset < (size_t) view->steps1) {
+                if (view->clockwise1) it1--;
+                else it1++;
+            } else {
+                if (view->clockwise2) it2--;
+                else it2++;
+            }
+        }
+
+        /**
+         * Returns iterator of ring that the current element is taken from
+         * @return iterator
+         */
+        const RingIterator &current() const { return offset < (size_t) view->steps1 ? it1 : it2; }
+
+    public:
+        /**
+         * Default constructor
+         */
+        Iterator() : view(nullptr), position(0), generated(0), offset(0) {}
+
+        /**
+         * Overwritten operator ++. Moves forward by one
+         * @return iterator
+         */
+        Iterator &operator++() {
+            if (++position >= view->size()) return *this;
+            if (!view->atBegin) forward();
+            else if (position == 1) view->seek(*this, view->size() - 1);
+            else backward();
+            return *this;
+        }
+
+        /**
+         * Overwritten operator ++. Moves forward by one
+         * @return iterator before moving
+         */
+        Iterator operator++(int) {
+            Iterator temporary(*this);
+            ++*this;
+            return temporary;
+        }
+
+        /**
+         * Overwritten operator ==, compares to iterators
+         * @param iterator iterator to be compared
+         * @return true if iterators point to same position, false otherwise
+         */
+        bool operator==(const Iterator &iterator) const { return position == iterator.position; }
+
+        /**
+         * Overwritten operator !=, compares to iterators
+         * @param iterator iterator to be compared
+         * @return false if iterators point to same position, true otherwise
+         */
+        bool operator!=(const Iterator &iterator) const { return position != iterator.position; }
+
+        /**
+         * Overwritten operator->. Used to access element of the ring
+         * @return pointer to element of the ring
+         */
+        auto operator->() const -> decltype(RingIterator().operator->()) { return current().operator->(); }
+
+        /**
+         * returns key
+         * @return key
+         */
+        K getKey() const { return current()->key; }
+
+        /**
+         * returns info
+         * @return info
+         */
+        T getInfo() const { return current()->info; }
+    };
+
+private:
+    /**
+     * Returns number of generated elements in one run of the algorithm
+     * @return steps1 + steps2
+     */
+    size_t round() const { return (size_t) steps1 + steps2; }
+
+    /**
+     * Moves iterator to given generated element
+     * @param iterator iterator
+     * @param generated number of generated element
+     */
+    void seek(Iterator &iterator, size_t generated) const {
+        size_t runs = generated / round();
+        iterator.generated = generated;
+        iterator.offset = generated % round();
+        size_t taken1 = runs * steps1 + min(iterator.offset, (size_t) steps1);
+        size_t taken2 = runs * steps2 + (iterator.offset > (size_t) steps1 ? iterator.offset - steps1 : 0);
+        iterator.it1 = locate(*ring1, start1, taken1, clockwise1);
+        iterator.it2 = locate(*ring2, start2, taken2, clockwise2);
+    }
+
+public:
+    /**
+     * Constructor with the same arguments as produce()
+     */
+    ProduceView(const Ring<K, T, S> &ring1, int start1, int steps1, const Ring<K, T, S> &ring2, int start2,
+                int steps2, int times, bool clockwise1, bool clockwise2, bool begin)
+            : ring1(&ring1), ring2(&ring2), start1(start1), steps1(max(steps1, 0)), start2(start2),
+              steps2(max(steps2, 0)), times(max(times, 0)), clockwise1(clockwise1), clockwise2(clockwise2),
+              atBegin(begin) {}
+
+    /**
+     * Returns number of elements, the same as size of ring returned by produce()
+     * @return number of elements
+     */
+    size_t size() const {
+        if (ring1->isEmpty() || ring2->isEmpty()) return 0;
+        return (size_t) times * round();
+    }
+
+    /**
+     * returns iterator to the first element
+     * @return begin iterator
+     */
+    Iterator begin() const {
+        Iterator iterator;
+        iterator.view = this;
+        if (size() == 0) return iterator;
+        iterator.it1 = ring1->constBegin();
+        iterator.it2 = ring2->constBegin();
+        iterator.it1 + start1;
+        iterator.it2 + start2;
+        return iterator;
+    }
+
+    /**
+     * returns iterator past the last element
+     * @return end iterator
+     */
+    Iterator end() const {
+        Iterator iterator;
+        iterator.view = this;
+        iterator.position = size();
+        return iterator;
+    }
+
+    /**
+     * Builds ring with all elements of the view
+     * @return the same ring as produce() returns
+     */
+    Ring<K, T, S> materialize() const {
+        return produce(*ring1, start1, steps1, *ring2, start2, steps2, times, clockwise1, clockwise2, atBegin);
+    }
+};
+
+/**
+ * Creates lazy view of produce() result, see ProduceView
+ * @return view
+ */
+template<typename K, typename T, typename S>
+ProduceView<K, T, S>
+produceView(const Ring<K, T, S> &ring1, int start1, int steps1, const Ring<K, T, S> &ring2, int start2, int steps2,
+            int times, bool clockwise1, bool clockwise2, bool begin) {
+    return ProduceView<K, T, S>(ring1, start1, steps1, ring2, start2, steps2, times, clockwise1, clockwise2, begin);
+}
+
+#endif //LAB_PRODUCE_CPP
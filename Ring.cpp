@@ -2,17 +2,48 @@
 // Created by Michał Nowaliński on 27-Nov-18.
 //
 
+#ifndef LAB_RING_CPP
+#define LAB_RING_CPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <vector>
+#include "AVLTree.cpp"
 
 using namespace std;
+
+/**
+ * Storage policy of Ring: every element is a separately allocated node linked by next and prev pointers
+ */
+struct LinkedStorage {};
+
+/**
+ * Storage policy of Ring: elements are kept in a growable circular array, the first N of them inside
+ * the ring object, see ArrayRing.cpp
+ * @tparam N number of elements kept inside the ring object, 0 or a power of two
+ */
+template<size_t N>
+struct InlineStorage {};
+
+/**
+ * Storage policy of Ring: elements are kept in a growable circular array on the heap, see ArrayRing.cpp
+ */
+typedef InlineStorage<0> ArrayStorage;
+
 /**
  * Data structure that extends double linked list with feature that last elements
  * point to the first elements
  * @tparam t1 key
  * @tparam t2 info
+ * @tparam Storage storage policy, LinkedStorage, ArrayStorage or InlineStorage<N>
  */
-template<typename t1, typename t2>
+template<typename t1, typename t2, typename Storage = LinkedStorage>
 class Ring {
     /**
      * Structure that holds an element of the list
@@ -47,12 +78,353 @@ class Ring {
         }
     };
 
+    /**
+     * Index from key to elements with that key. It is used through this interface so that the hash
+     * of t1 is required only by rings which enable the index.
+     */
+    struct KeyIndex {
+        virtual ~KeyIndex() {}
+
+        /**
+         * Creates empty index of the same kind
+         * @return new index
+         */
+        virtual KeyIndex *fresh() const = 0;
+
+        /**
+         * Adds element to the index
+         * @param element element
+         */
+        virtual void insert(Element *element) = 0;
+
+        /**
+         * Removes element from the index
+         * @param element element
+         */
+        virtual void erase(Element *element) = 0;
+
+        /**
+         * Looks for element with given key
+         * @param key key
+         * @param element element with given key, nullptr if there is none
+         * @return number of elements with given key, 0, 1 or 2 for two or more
+         */
+        virtual size_t find(const t1 &key, Element *&element) const = 0;
+
+        /**
+         * Removes all elements from the index
+         */
+        virtual void clear() = 0;
+    };
+
+    /**
+     * KeyIndex kept in a hash table
+     * @tparam Hash hash of t1
+     */
+    template<typename Hash>
+    struct HashIndex : KeyIndex {
+        /**
+         * key to element map
+         */
+        unordered_multimap<t1, Element *, Hash> elements;
+
+        KeyIndex *fresh() const override { return new HashIndex(); }
+
+        void insert(Element *element) override { elements.emplace(element->key, element); }
+
+        void erase(Element *element) override {
+            auto range = elements.equal_range(element->key);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second == element) {
+                    elements.erase(it);
+                    return;
+                }
+            }
+        }
+
+        size_t find(const t1 &key, Element *&element) const override {
+            auto range = elements.equal_range(key);
+            element = range.first == range.second ? nullptr : range.first->second;
+            if (!element) return 0;
+            return std::next(range.first) != range.second ? 2 : 1;
+        }
+
+        void clear() override { elements.clear(); }
+    };
+
+    /**
+     * Tree of elements with given key, in order of adding them to the index
+     */
+    typedef AVLTree<t1, vector<Element *>> OrderedTree;
+
+    /**
+     * KeyIndex kept in AVLTree, it gives elements in order of keys
+     */
+    struct OrderedIndex : KeyIndex {
+        /**
+         * key to elements tree
+         */
+        OrderedTree elements;
+
+        KeyIndex *fresh() const override { return new OrderedIndex(); }
+
+        void insert(Element *element) override {
+            auto *node = elements.searchKey(element->key);
+            if (node) node->value.push_back(element);
+            else elements.insert(element->key, vector<Element *>(1, element));
+        }
+
+        void erase(Element *element) override {
+            auto *node = elements.searchKey(element->key);
+            if (!node) return;
+            vector<Element *> &same = node->value;
+            for (size_t i = 0; i < same.size(); i++) {
+                if (same[i] == element) {
+                    same.erase(same.begin() + i);
+                    break;
+                }
+            }
+            if (same.empty()) elements.remove(element->key);
+        }
+
+        size_t find(const t1 &key, Element *&element) const override {
+            auto *node = const_cast<OrderedTree &>(elements).searchKey(key);
+            element = node ? node->value.front() : nullptr;
+            return node ? (node->value.size() > 1 ? 2 : 1) : 0;
+        }
+
+        void clear() override { elements.clear(); }
+    };
+
     /**
      * first element in the ring
      */
     Element *head;
 
+    /**
+     * key index, nullptr if it is not enabled
+     */
+    KeyIndex *index;
+
+    /**
+     * ordered index, nullptr if it is not enabled. It is used through KeyIndex, so that operator < of t1
+     * is required only by rings which enable it.
+     */
+    KeyIndex *ordered;
+
+    /**
+     * true if iteration follows prev links instead of next links
+     */
+    bool reversed;
+
+    /**
+     * number of elements
+     */
+    size_t count;
+
+    /**
+     * skip markers: every markerStride-th element counting from head, empty if they are out of date.
+     * They are built by non-const segments() and dropped by any change of the ring's shape, const
+     * segments() only reads them.
+     */
+    vector<Element *> markers;
+
+    /**
+     * distance between consecutive skip markers
+     */
+    size_t markerStride;
+
+    /**
+     * Looks for the first element with given key, counting from head in order of iteration. Key index or
+     * ordered index, if one is enabled, answers for keys that are absent or unique, the ring is scanned for
+     * keys that several elements have, so indexes never change which element is found.
+     * @param key key
+     * @return element with given key or nullptr
+     */
+    Element *lookup(const t1 &key) const {
+        KeyIndex *used = index ? index : ordered;
+        Element *found = nullptr;
+        if (used && used->find(key, found) < 2) return found;
+        if (!head) return nullptr;
+        Element *element = head;
+        do {
+            if (element->key == key) return element;
+            element = after(element);
+        } while (element != head);
+        return nullptr;
+    }
+
+    /**
+     * Returns link to the element that follows given one in iteration order, next or prev if ring is
+     * reversed
+     * @param element element
+     * @return reference to the link
+     */
+    Element *&after(Element *element) const { return reversed ? element->prev : element->next; }
+
+    /**
+     * Returns link to the element that precedes given one in iteration order, prev or next if ring is
+     * reversed
+     * @param element element
+     * @return reference to the link
+     */
+    Element *&before(Element *element) const { return reversed ? element->next : element->prev; }
+
+    /**
+     * Adds element to enabled indexes
+     * @param element element
+     */
+    void track(Element *element) {
+        if (index) index->insert(element);
+        if (ordered) ordered->insert(element);
+    }
+
+    /**
+     * Removes element from enabled indexes
+     * @param element element
+     */
+    void untrack(Element *element) {
+        if (index) index->erase(element);
+        if (ordered) ordered->erase(element);
+    }
+
+    /**
+     * Checks if ring has to visit every added or removed element to keep indexes up to date
+     * @return true if key index or ordered index is enabled
+     */
+    bool tracked() const { return index || ordered; }
+
+    /**
+     * Ordered index of the ring, throws if it is not enabled
+     * @return ordered index
+     */
+    OrderedIndex &orderedIndex() const {
+        if (!ordered) throw std::runtime_error("Ordered index is not enabled");
+        return *static_cast<OrderedIndex *>(ordered);
+    }
+
+    /**
+     * Swaps next and prev of every element and flips reversed, so order of the ring does not change but
+     * iteration follows the other links
+     */
+    void flipLinks() {
+        if (head) {
+            Element *element = head;
+            do {
+                std::swap(element->next, element->prev);
+                element = element->next;
+            } while (element != head);
+        }
+        reversed = !reversed;
+    }
+
+    /**
+     * Makes next links follow order of iteration, swapping next and prev of every element if ring is
+     * reversed. Order of the ring does not change.
+     */
+    void straighten() {
+        if (reversed) flipLinks();
+    }
+
+    /**
+     * Cuts the ring open, ring has to be straightened. Ring is left with no head, but its elements,
+     * count and indexes are kept.
+     * @return first element, next link of the last element is nullptr
+     */
+    Element *detach() {
+        Element *first = head;
+        if (first) first->prev->next = nullptr;
+        head = nullptr;
+        markers.clear();
+        return first;
+    }
+
+    /**
+     * Closes list linked by next links into the ring, restoring prev links
+     * @param first first element of the list
+     */
+    void attach(Element *first) {
+        head = first;
+        if (!first) return;
+        Element *element = first;
+        while (element->next) {
+            element->next->prev = element;
+            element = element->next;
+        }
+        element->next = first;
+        first->prev = element;
+    }
+
+    /**
+     * Merges two sorted lists linked by next links, elements of first list go first among equal keys
+     * @tparam Compare comparator of keys
+     * @param first first list
+     * @param second second list
+     * @param comp returns true if first key goes before second
+     * @return merged list
+     */
+    template<typename Compare>
+    static Element *mergeLists(Element *first, Element *second, Compare &comp) {
+        Element *merged = nullptr, **tail = &merged;
+        while (first && second) {
+            if (comp(second->key, first->key)) {
+                *tail = second;
+                second = second->next;
+            } else {
+                *tail = first;
+                first = first->next;
+            }
+            tail = &(*tail)->next;
+        }
+        *tail = first ? first : second;
+        return merged;
+    }
+
+    /**
+     * Links element at the end of the ring
+     * @param element element that does not belong to any ring
+     * @return element
+     */
+    Element *linkEnd(Element *element) {
+        track(element);
+        markers.clear();
+        count++;
+        if (!head) {
+            element->next = element;
+            element->prev = element;
+            head = element;
+            return element;
+        }
+        before(element) = before(head);
+        after(element) = head;
+        after(before(element)) = element;
+        before(head) = element;
+        return element;
+    }
+
+    /**
+     * Unlinks element from the ring without deleting it
+     * @param element element of the ring
+     */
+    void unlink(Element *element) {
+        untrack(element);
+        markers.clear();
+        count--;
+        if (element->next == element) {
+            head = nullptr;
+        } else {
+            after(before(element)) = after(element);
+            before(after(element)) = before(element);
+            if (element == head) head = after(element);
+        }
+    }
+
 public:
+    /**
+     * Pointer to an element of the ring. It stays valid until the element is removed from the ring
+     */
+    typedef Element *Handle;
+
     /**
      * Class object that iterates throughout full ring.
      * @tparam K key
@@ -61,17 +433,40 @@ public:
     template<typename K, typename I>
     class Iterator {
         Element *it;
+        /**
+         * true if iterator of reversed ring, it follows prev links when moving forwards
+         */
+        bool backward;
+
+        /**
+         * Returns element after current one in iteration order
+         * @return next element
+         */
+        Element *following() const { return backward ? it->prev : it->next; }
+
+        /**
+         * Returns element before current one in iteration order
+         * @return previous element
+         */
+        Element *preceding() const { return backward ? it->next : it->prev; }
     public:
         /**
          * Default constructor
          */
-        Iterator() { it = nullptr; }
+        Iterator() {
+            it = nullptr;
+            backward = false;
+        }
 
         /**
          * Constructor with element iterator points to
-         * @param node
+         * @param element element
+         * @param backward true if ring is reversed
          */
-        Iterator(Element *element) { it = element; }
+        Iterator(Element *element, bool backward = false) {
+            it = element;
+            this->backward = backward;
+        }
 
         /**
          * Destructor
@@ -82,7 +477,10 @@ public:
          * Copying constructor
          * @param cc iterator to be copied
          */
-        Iterator(const Iterator &cc) { it = cc.it; }
+        Iterator(const Iterator &cc) {
+            it = cc.it;
+            backward = cc.backward;
+        }
 
         /**
          * Overwritten operator =
@@ -92,6 +490,7 @@ public:
         Iterator operator=(const Iterator &iterator) {
             if (this == &iterator) return *this;
             it = iterator.it;
+            backward = iterator.backward;
             return *this;
         }
 
@@ -101,7 +500,7 @@ public:
          * @return iterator
          */
         Iterator operator+(int length) {
-            if (length > 0)for (int i = 0; it && it->next && i < length; i++) it = it->next;
+            if (length > 0)for (int i = 0; it && i < length; i++) it = following();
             return *this;
         }
 
@@ -111,7 +510,7 @@ public:
          * @return iterator
          */
         Iterator operator-(int length) {
-            if (length > 0)for (int i = 0; it && it->next && i < length; i++) it = it->prev;
+            if (length > 0)for (int i = 0; it && i < length; i++) it = preceding();
             return *this;
         }
 
@@ -120,21 +519,18 @@ public:
          * @return iterator
          */
         Iterator &operator++() {
-            if (!it) it = it->next;
+            if (it) it = following();
             return *this;
         }
 
         /**
          * Overwritten operator ++. Moves forward by one
-         * @return iterator
+         * @return iterator before moving
          */
-        Iterator &operator++(int) {
-            if (!it) return *this;
-            else {
-                auto *temporary = new Iterator(it);
-                it = it->next;
-                return *temporary;
-            }
+        Iterator operator++(int) {
+            Iterator temporary(*this);
+            if (it) it = following();
+            return temporary;
         }
 
         /**
@@ -142,21 +538,18 @@ public:
          * @return iterator
          */
         Iterator &operator--() {
-            if (it) it = it->prev;
+            if (it) it = preceding();
             return *this;
         }
 
         /**
          * Overwritten operator --. Moves backword by one
-         * @return iterator
+         * @return iterator before moving
          */
-        Iterator &operator--(int) {
-            if (!it) return *this;
-            else {
-                auto *temporary = new Iterator(it);
-                it = it->prev;
-                return *temporary;
-            }
+        Iterator operator--(int) {
+            Iterator temporary(*this);
+            if (it) it = preceding();
+            return temporary;
         }
 
         /**
@@ -213,93 +606,339 @@ public:
     typedef Iterator<t1, t2> RingIterator;
     typedef Iterator<const t1, const t2> ConstRingIterator;
 
+    /**
+     * Class object that iterates over elements of the ring in order of keys, using ordered index.
+     * Adding or removing elements invalidates it.
+     */
+    class OrderedIterator {
+        /**
+         * node of ordered index with key of current element
+         */
+        typename OrderedTree::TreeIterator node;
+        /**
+         * position of current element among elements with the same key
+         */
+        size_t position;
+    public:
+        /**
+         * Default constructor, iterator past the last element
+         */
+        OrderedIterator() : position(0) {}
+
+        /**
+         * Constructor with node of ordered index, iterator points to its first element
+         * @param node node
+         */
+        OrderedIterator(typename OrderedTree::TreeIterator node) : node(node), position(0) {}
+
+        /**
+         * Overwritten operator ++. Moves to element with the same or the next larger key
+         * @return iterator
+         */
+        OrderedIterator &operator++() {
+            if (node == typename OrderedTree::TreeIterator()) return *this;
+            if (++position == node->value.size()) {
+                ++node;
+                position = 0;
+            }
+            return *this;
+        }
+
+        /**
+         * Overwritten operator ++. Moves to element with the same or the next larger key
+         * @return iterator before moving
+         */
+        OrderedIterator operator++(int) {
+            OrderedIterator temporary(*this);
+            ++*this;
+            return temporary;
+        }
+
+        /**
+         * Overwritten operator ==, compares to iterators
+         * @param iterator iterator to be compared
+         * @return true if iterators point to same object, false otherwise
+         */
+        bool operator==(const OrderedIterator &iterator) const {
+            return node == iterator.node && position == iterator.position;
+        }
+
+        /**
+         * Overwritten operator !=, compares to iterators
+         * @param iterator iterator to be compared
+         * @return false if iterators point to same object, true otherwise
+         */
+        bool operator!=(const OrderedIterator &iterator) const { return !(*this == iterator); }
+
+        /**
+         * Overwritten operator *, return object via accessing pointer
+         * @return element
+         */
+        Element &operator*() const { return *node->value[position]; }
+
+        /**
+         * Overwritten operator->. Used to access element
+         * @return element
+         */
+        Element *operator->() const { return node->value[position]; }
+    };
+
     /**
      * returns iterator to begin
      * @return begin iterator
      */
-    RingIterator begin() { return RingIterator(head); }
+    RingIterator begin() { return RingIterator(head, reversed); }
 
     /**
      * returns iterator to end
      * @return end interator
      */
-    RingIterator end() { return RingIterator(head); }
+    RingIterator end() { return RingIterator(head, reversed); }
 
     /**
      * returns iterator to last element
      * @return iterator to last element
      */
-    RingIterator last() { return !head ? RingIterator(nullptr) : RingIterator(head->prev); }
+    RingIterator last() { return !head ? RingIterator(nullptr) : RingIterator(before(head), reversed); }
 
     /**
-     * Searches for iterator with given value
+     * Searches for the first element with given key, counting from head, whether indexes are enabled or not
      * @param value value
      * @return iterator with given value
      */
-    RingIterator find(const t1 &value) {
-        for (RingIterator iter = begin(); iter != last(); ++iter) if (iter->key == value) return iter;
-        return RingIterator(nullptr);
-    }
+    RingIterator find(const t1 &value) { return RingIterator(lookup(value), reversed); }
 
     /**
      * returns iterator pointing to the first element
      * @return iterator pointing to the first element
      */
-    ConstRingIterator constBegin() const { return ConstRingIterator(head); }
+    ConstRingIterator constBegin() const { return ConstRingIterator(head, reversed); }
 
     /**
      * returns iterator pointing to the last element
      * @return iterator pointing to the last element
      */
-    ConstRingIterator constEnd() const { return ConstRingIterator(head); }
+    ConstRingIterator constEnd() const { return ConstRingIterator(head, reversed); }
 
     /**
      * returns last iterator
      * @return last iterator
      */
-    ConstRingIterator constLast() const { return !head ? ConstRingIterator(nullptr) : ConstRingIterator(head->prev); }
+    ConstRingIterator constLast() const {
+        return !head ? ConstRingIterator(nullptr) : ConstRingIterator(before(head), reversed);
+    }
 
     /**
      * Look for iterator with given value
      * @param value value
      * @return iterator with given value
      */
-    ConstRingIterator constFind(const t1 &value) const {
-        for (ConstRingIterator iter = begin(); iter != last(); ++iter) if (iter->key == value) return iter;
-        return ConstRingIterator(nullptr);
-    }
+    ConstRingIterator constFind(const t1 &value) const { return ConstRingIterator(lookup(value), reversed); }
+
+    /**
+     * Checks if the ring has element with given key
+     * @param value key
+     * @return true if there is such element, false otherwise
+     */
+    bool contains(const t1 &value) const { return lookup(value) != nullptr; }
 
     /**
      * default constructor
      */
-    Ring() { head = nullptr; }
+    Ring() {
+        head = nullptr;
+        index = nullptr;
+        ordered = nullptr;
+        reversed = false;
+        count = 0;
+        markerStride = 0;
+    }
 
     /**
      * destroyer
      */
-    ~Ring() { destroy(); }
+    ~Ring() {
+        destroy();
+        delete index;
+        delete ordered;
+    }
 
     /**
-     *
-     * @param cc
+     * Copying constructor, the copy has key index and ordered index if cc has them
+     * @param cc ring to be copied
      */
-    Ring(const Ring<t1, t2> &cc) {
+    Ring(const Ring &cc) {
         head = nullptr;
+        index = cc.index ? cc.index->fresh() : nullptr;
+        ordered = cc.ordered ? cc.ordered->fresh() : nullptr;
+        reversed = false;
+        count = 0;
+        markerStride = 0;
         if (!cc.isEmpty()) copy(cc);
     }
 
     /**
-     * Overwritten operator =
+     * Enables key index. find, contains and remove use it and cost O(1) on average instead of O(n).
+     * Every addition and removal keeps it up to date, removal costs O(k) for k elements with the same key.
+     * Keys that several elements have are still looked for by scanning, so that the same element is found
+     * or removed as without index.
+     * @tparam Hash hash of t1
+     */
+    template<typename Hash = hash<t1>>
+    void enableIndex() {
+        if (index) return;
+        index = new HashIndex<Hash>();
+        if (!head) return;
+        Element *element = head;
+        do {
+            index->insert(element);
+            element = element->next;
+        } while (element != head);
+    }
+
+    /**
+     * Disables key index, find, contains and remove scan the ring again
+     */
+    void disableIndex() {
+        delete index;
+        index = nullptr;
+    }
+
+    /**
+     * Checks if key index is enabled
+     * @return true if key index is enabled
+     */
+    bool isIndexed() const { return index != nullptr; }
+
+    /**
+     * Enables ordered index, AVLTree from key to elements that is kept up to date by every addition and
+     * removal, while order of the ring stays as it is. Elements can be then visited in order of keys and
+     * the smallest and the largest key is found in O(log n). Without key index, find, contains and remove
+     * use it too and cost O(log n) for keys of at most one element, keys of several elements are scanned
+     * for, so that the same element is found or removed as without index. Adding an element costs
+     * O(log n) more and removing it O(log n + k) more, for k elements with the same key.
+     * Elements with equal keys are visited in order of adding them to the index.
+     */
+    void enableOrderedIndex() {
+        if (ordered) return;
+        ordered = new OrderedIndex();
+        if (!head) return;
+        Element *element = head;
+        do {
+            ordered->insert(element);
+            element = after(element);
+        } while (element != head);
+    }
+
+    /**
+     * Disables ordered index
+     */
+    void disableOrderedIndex() {
+        delete ordered;
+        ordered = nullptr;
+    }
+
+    /**
+     * Checks if ordered index is enabled
+     * @return true if ordered index is enabled
+     */
+    bool isOrdered() const { return ordered != nullptr; }
+
+    /**
+     * Returns iterator to element with the smallest key, ordered index has to be enabled
+     * @return ordered iterator, equal to orderedEnd() if ring is empty
+     */
+    OrderedIterator orderedBegin() const { return OrderedIterator(orderedIndex().elements.begin()); }
+
+    /**
+     * Returns iterator past element with the largest key
+     * @return ordered iterator
+     */
+    OrderedIterator orderedEnd() const { return OrderedIterator(); }
+
+    /**
+     * Looks for the first element, in order of keys, whose key is not less than given key. Costs O(log n),
+     * ordered index has to be enabled
+     * @param key key
+     * @return ordered iterator, orderedEnd() if every key is less than given key
+     */
+    OrderedIterator lowerBound(const t1 &key) const { return OrderedIterator(orderedIndex().elements.lowerBound(key)); }
+
+    /**
+     * Returns element with the smallest key in O(log n), ordered index has to be enabled
+     * @return iterator in order of the ring, pointing to nothing if ring is empty
+     */
+    RingIterator minimum() const {
+        auto node = orderedIndex().elements.begin();
+        return node == orderedIndex().elements.end() ? RingIterator() : RingIterator(node->value.front(), reversed);
+    }
+
+    /**
+     * Returns element with the largest key in O(log n), ordered index has to be enabled
+     * @return iterator in order of the ring, pointing to nothing if ring is empty
+     */
+    RingIterator maximum() const {
+        auto node = orderedIndex().elements.last();
+        return node == orderedIndex().elements.end() ? RingIterator() : RingIterator(node->value.front(), reversed);
+    }
+
+    /**
+     * Overwritten operator =, indexes of the ring stay enabled or disabled as they were
      * @param rhs to which ring ring is asigned
      * @return reference to the ring
      */
-    Ring<t1, t2> &operator=(const Ring<t1, t2> &rhs) {
+    Ring &operator=(const Ring &rhs) {
         if (this == &rhs) return *this;
         destroy();
         if (!rhs.isEmpty()) copy(rhs);
         return *this;
     }
 
+    /**
+     * Moving constructor, takes over elements and indexes of cc, which is left empty
+     * @param cc ring to be moved
+     */
+    Ring(Ring &&cc) noexcept : markers(std::move(cc.markers)) {
+        head = cc.head;
+        index = cc.index;
+        ordered = cc.ordered;
+        reversed = cc.reversed;
+        count = cc.count;
+        markerStride = cc.markerStride;
+        cc.head = nullptr;
+        cc.index = nullptr;
+        cc.ordered = nullptr;
+        cc.reversed = false;
+        cc.count = 0;
+        cc.markers.clear();
+    }
+
+    /**
+     * Moving operator =, takes over elements and indexes of rhs, which is left empty
+     * @param rhs ring to be moved
+     * @return reference to the ring
+     */
+    Ring &operator=(Ring &&rhs) noexcept {
+        if (this == &rhs) return *this;
+        destroy();
+        delete index;
+        delete ordered;
+        head = rhs.head;
+        index = rhs.index;
+        ordered = rhs.ordered;
+        reversed = rhs.reversed;
+        count = rhs.count;
+        markers = std::move(rhs.markers);
+        markerStride = rhs.markerStride;
+        rhs.head = nullptr;
+        rhs.index = nullptr;
+        rhs.ordered = nullptr;
+        rhs.reversed = false;
+        rhs.count = 0;
+        rhs.markers.clear();
+        return *this;
+    }
+
     /**
      * return head
      * @return head
@@ -312,21 +951,126 @@ public:
      * adds key and value to the ring at end
      * @param key key to be added
      * @param info infor to be added
+     * @return handle to the added element
      */
-    void addEnd(const t1 &key, const t2 &info) {
+    Handle addEnd(const t1 &key, const t2 &info) {
         Element *adder = new Element;
         adder->key = key;
         adder->info = info;
+        return linkEnd(adder);
+    }
+
+    /**
+     * adds key and value to the ring just before given element
+     * @param position element before which new element is linked, it has to belong to this ring
+     * @param key key to be added
+     * @param info infor to be added
+     * @return handle to the added element
+     */
+    Handle insertBefore(Handle position, const t1 &key, const t2 &info) {
+        if (!position) return addEnd(key, info);
+        Element *adder = new Element;
+        adder->key = key;
+        adder->info = info;
+        track(adder);
+        markers.clear();
+        count++;
+        before(adder) = before(position);
+        after(adder) = position;
+        after(before(adder)) = adder;
+        before(position) = adder;
+        return adder;
+    }
+
+    /**
+     * Relinks given element so that it becomes the head of the ring. No element is allocated or copied
+     * @param element element to be moved, it has to belong to this ring
+     */
+    void moveToFront(Handle element) {
+        if (element == head) return;
+        markers.clear();
+        after(before(element)) = after(element);
+        before(after(element)) = before(element);
+        before(element) = before(head);
+        after(element) = head;
+        after(before(head)) = element;
+        before(head) = element;
+        head = element;
+    }
+
+    /**
+     * Unlinks given element from the ring and deletes it
+     * @param element element to be removed, it has to belong to this ring
+     */
+    void erase(Handle element) {
+        unlink(element);
+        delete element;
+    }
+
+    /**
+     * Moves all elements of other ring to the end of this ring by relinking, other ring is left empty.
+     * Costs O(1), or O(m) if either ring has key index or ordered index or rings are reversed differently.
+     * @param other ring whose elements are moved
+     */
+    void splice(Ring &other) {
+        if (this == &other || other.isEmpty()) return;
+        splice(other, other.begin(), other.last());
+    }
+
+    /**
+     * Moves elements from first to last inclusive, counting clockwise, from other ring to the end of
+     * this ring by relinking. Range must not pass over end of other ring, that is head of other may be
+     * only its first element. Costs O(k), as moved elements are counted to keep sizes of both rings.
+     * @param other ring whose elements are moved
+     * @param first first element to be moved
+     * @param last last element to be moved
+     */
+    void splice(Ring &other, RingIterator first, RingIterator last) {
+        Element *from = first.operator->(), *to = last.operator->();
+        if (this == &other || !from || !to) return;
+        if (!head) reversed = other.reversed;
+        if (reversed != other.reversed) {
+            while (true) {
+                Element *following = other.after(from);
+                other.unlink(from);
+                linkEnd(from);
+                if (from == to) return;
+                from = following;
+            }
+        }
+        size_t moved = 0;
+        if (tracked() || other.tracked() || after(to) != from) {
+            Element *element = from;
+            while (true) {
+                other.untrack(element);
+                track(element);
+                moved++;
+                if (element == to) break;
+                element = after(element);
+            }
+        } else moved = other.count;
+        count += moved;
+        other.count -= moved;
+        markers.clear();
+        other.markers.clear();
+        if (after(to) == from) {
+            other.head = nullptr;
+        } else {
+            after(before(from)) = after(to);
+            before(after(to)) = before(from);
+            if (other.head == from) other.head = after(to);
+        }
         if (!head) {
-            adder->next = adder;
-            adder->prev = adder;
-            head = adder;
+            before(from) = to;
+            after(to) = from;
+            head = from;
             return;
         }
-        adder->prev = head->prev;
-        adder->next = head;
-        adder->prev->next = adder;
-        head->prev = adder;
+        Element *tail = before(head);
+        after(tail) = from;
+        before(from) = tail;
+        after(to) = head;
+        before(head) = to;
     }
 
     /**
@@ -338,16 +1082,19 @@ public:
         Element *adder = new Element;
         adder->key = key;
         adder->info = info;
+        track(adder);
+        markers.clear();
+        count++;
         if (!head) {
-            adder->next = adder;
-            adder->prev = adder;
+            after(adder) = adder;
+            before(adder) = adder;
             head = adder;
             return;
         }
-        adder->next = head->next;
-        adder->prev = head;
-        adder->next->prev = adder;
-        head->next = adder;
+        after(adder) = after(head);
+        before(adder) = head;
+        before(after(adder)) = adder;
+        after(head) = adder;
     }
 
     /**
@@ -357,30 +1104,116 @@ public:
     void add(const ConstRingIterator &iter) { addEnd(iter->key, iter->info); }
 
     /**
-     * Removes given value form the ring
-     * @param value value to be removed
+     * Rotates the ring, element that is steps positions after head becomes the head. Only head is moved,
+     * in the shorter direction, so it costs O(min(k, n - k)) for k = steps mod n and no element is relinked.
+     * @param steps number of positions, negative rotates the other way
      */
-    void remove(const t1 &value) {
-        if (isEmpty()) return;
-        else {
-            if (head->next == head || head->prev == head) {
-                delete head;
-                head = nullptr;
-            } else {
-                Element *before = head->prev;
-                Element *after = head->next;
-                before->next = after;
-                after->prev = before;
-                delete head;
-                head = after;
+    void rotate(long steps) {
+        if (!head) return;
+        long shift = steps % (long) count;
+        if (shift < 0) shift += count;
+        if (shift == 0) return;
+        markers.clear();
+        if ((size_t) shift <= count / 2) for (; shift > 0; shift--) head = after(head);
+        else for (shift = count - shift; shift > 0; shift--) head = before(head);
+    }
+
+    /**
+     * Reverses order of the ring in O(1). Only direction of iteration is flipped, next and prev links of
+     * elements are not touched: the last element becomes the head and iterating forwards follows prev
+     * links. Reversing twice restores the ring.
+     */
+    void reverse() {
+        if (head) head = before(head);
+        markers.clear();
+        reversed = !reversed;
+    }
+
+    /**
+     * Checks if iteration follows prev links
+     * @return true if ring was reversed odd number of times
+     */
+    bool isReversed() const { return reversed; }
+
+    /**
+     * Sorts the ring by keys with bottom-up merge sort, the smallest key becomes the head. Elements are
+     * only relinked: nothing is allocated or copied, handles and iterators stay valid and indexes need
+     * no update. A reversed ring is sorted along next links and its links are swapped back afterwards,
+     * so iterators keep their direction. Sort is stable. Costs O(n log n) time and O(1) memory.
+     * @tparam Compare comparator of keys
+     * @param comp returns true if first key goes before second
+     */
+    template<typename Compare = less<t1>>
+    void sort(Compare comp = Compare()) {
+        if (count < 2) return;
+        bool wasReversed = reversed;
+        straighten();
+        Element *bins[64] = {};
+        Element *list = detach();
+        while (list) {
+            Element *carry = list;
+            list = list->next;
+            carry->next = nullptr;
+            size_t i = 0;
+            for (; bins[i]; i++) {
+                carry = mergeLists(bins[i], carry, comp);
+                bins[i] = nullptr;
             }
+            bins[i] = carry;
         }
+        Element *sorted = nullptr;
+        for (Element *bin : bins) if (bin) sorted = mergeLists(bin, sorted, comp);
+        attach(sorted);
+        if (wasReversed) flipLinks();
+    }
+
+    /**
+     * Moves all elements of other ring into this ring, both of them have to be sorted with comp.
+     * Elements are relinked in O(n + m) without allocation, other ring is left empty and the result
+     * is sorted, elements of this ring go first among equal keys. Costs O(m) more if either ring
+     * has key index or ordered index, and O(n + m) more if this ring is reversed, as its links are swapped
+     * back so that its iterators keep their direction. Iterators to elements of other ring stay valid if
+     * it was reversed as many times as this ring, modulo 2.
+     * @tparam Compare comparator of keys
+     * @param other sorted ring
+     * @param comp returns true if first key goes before second
+     */
+    template<typename Compare = less<t1>>
+    void merge(Ring &other, Compare comp = Compare()) {
+        if (this == &other || !other.head) return;
+        bool wasReversed = reversed;
+        straighten();
+        other.straighten();
+        if (tracked() || other.tracked()) {
+            Element *element = other.head;
+            do {
+                other.untrack(element);
+                track(element);
+                element = element->next;
+            } while (element != other.head);
+        }
+        count += other.count;
+        other.count = 0;
+        attach(mergeLists(detach(), other.detach(), comp));
+        if (wasReversed) flipLinks();
+    }
+
+    /**
+     * Removes element with given key form the ring, if there is no such element nothing happens.
+     * The first element with the key, counting from head, is removed, whether indexes are enabled or not.
+     * @param value key of element to be removed
+     */
+    void remove(const t1 &value) {
+        Element *element = lookup(value);
+        if (element) erase(element);
     }
 
     /**
      * Destroys ring
      */
     void destroy() {
+        if (index) index->clear();
+        if (ordered) ordered->clear();
         while (!isEmpty()) {
             if (head->next == head || head->prev == head) {
                 delete head;
@@ -394,14 +1227,119 @@ public:
                 head = ntr;
             }
         }
+        reversed = false;
+        count = 0;
+        markers.clear();
+    }
+
+    /**
+     * Returns number of elements
+     * @return number of elements
+     */
+    size_t size() const { return count; }
+
+    /**
+     * Part of the ring: length consecutive elements starting at first
+     * @tparam Iterator RingIterator or ConstRingIterator
+     */
+    template<typename Iterator>
+    struct BasicSegment {
+        /**
+         * first element of the segment
+         */
+        Iterator first;
+        /**
+         * number of elements
+         */
+        size_t length;
+    };
+
+    typedef BasicSegment<RingIterator> Segment;
+    typedef BasicSegment<ConstRingIterator> ConstSegment;
+
+private:
+    /**
+     * Checks if skip markers are dense enough to cut the ring into parts segments
+     * @param parts number of segments, not greater than size()
+     * @return true if markers can be used
+     */
+    bool markersFit(size_t parts) const {
+        return !markers.empty() && markerStride <= max<size_t>(1, count / (parts * 16));
+    }
+
+    /**
+     * Walks the ring once and collects every stride-th element counting from head
+     * @param marks vector elements are put into
+     * @param parts number of segments the markers are built for
+     * @return distance between consecutive markers
+     */
+    size_t buildMarkers(vector<Element *> &marks, size_t parts) const {
+        size_t stride = max<size_t>(1, count / (max<size_t>(parts, 16) * 16));
+        marks.clear();
+        Element *element = head;
+        for (size_t i = 0; i < count; i++, element = after(element))
+            if (i % stride == 0) marks.push_back(element);
+        return stride;
+    }
+
+    /**
+     * Cuts the ring at skip markers
+     * @tparam Iterator type of iterators of segments
+     * @param parts number of segments, not greater than size()
+     * @param marks every stride-th element counting from head
+     * @param stride distance between consecutive markers
+     * @return segments in order of iteration
+     */
+    template<typename Iterator>
+    vector<BasicSegment<Iterator>> cut(size_t parts, const vector<Element *> &marks, size_t stride) const {
+        vector<BasicSegment<Iterator>> result;
+        size_t begin = 0;
+        for (size_t i = 0; i < parts; i++) {
+            size_t end = i + 1 == parts ? count : (i + 1) * count / parts / stride * stride;
+            result.push_back({Iterator(marks[begin / stride], reversed), end - begin});
+            begin = end;
+        }
+        return result;
+    }
+
+public:
+    /**
+     * Cuts the ring into parts consecutive segments of roughly equal length, covering it exactly once
+     * starting at head. Boundaries are taken from skip markers; building them walks the ring once, after
+     * that they are reused by later calls until the ring changes, so repeated scans of the same ring cut
+     * it in O(parts). Lengths differ by at most 1/16 of the average length.
+     * @param parts number of segments, lowered to size() if the ring is smaller
+     * @return segments in order of iteration, empty if ring is empty or parts is 0
+     */
+    vector<Segment> segments(size_t parts) {
+        if (!head || parts == 0) return vector<Segment>();
+        if (parts > count) parts = count;
+        if (!markersFit(parts)) markerStride = buildMarkers(markers, parts);
+        return cut<RingIterator>(parts, markers, markerStride);
+    }
+
+    /**
+     * Cuts the ring into segments as segments() does, but never changes the ring, so many threads may
+     * call it at once. Skip markers are used if segments() left them dense enough, otherwise they are
+     * built for this call only, walking the ring once.
+     * @param parts number of segments, lowered to size() if the ring is smaller
+     * @return segments in order of iteration, empty if ring is empty or parts is 0
+     */
+    vector<ConstSegment> segments(size_t parts) const {
+        if (!head || parts == 0) return vector<ConstSegment>();
+        if (parts > count) parts = count;
+        if (markersFit(parts)) return cut<ConstRingIterator>(parts, markers, markerStride);
+        vector<Element *> marks;
+        size_t stride = buildMarkers(marks, parts);
+        return cut<ConstRingIterator>(parts, marks, stride);
     }
 
     /**
      * Copies ring
      * @param ring ring to copy
      */
-    void copy(const Ring<t1, t2> &ring) {
-        Ring<t1, t2>::ConstRingIterator iter = ring.constBegin();
+    void copy(const Ring &ring) {
+        ConstRingIterator iter = ring.constBegin();
         do {
             add(iter);
             iter++;
@@ -421,7 +1359,7 @@ public:
      * @return ostream
      */
     friend ostream &operator<<(ostream &output, const Ring &ring) {
-        Ring<t1, t2>::ConstRingIterator iterator = ring.constBegin();
+        ConstRingIterator iterator = ring.constBegin();
         do {
             output << iterator.getKey() << " " << iterator.getInfo() << endl;
             iterator++;
@@ -430,3 +1368,5 @@ public:
         return output;
     }
 };
+
+#endif //LAB_RING_CPP
@@ -0,0 +1,375 @@
+#ifndef LAB_RINGQUEUE_CPP
+#define LAB_RINGQUEUE_CPP
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+/**
+ * Assumed size of cache line. Indices written by different threads are kept this far apart,
+ * so that producers and consumers do not invalidate each other's cache lines.
+ */
+const size_t CACHE_LINE = 64;
+
+/**
+ * Fixed capacity ring queue for exactly one producer thread and one consumer thread. Elements are kept
+ * in a circular array whose capacity is a power of two. Producer owns tail and consumer owns head,
+ * each of them reads the other one's index only when its cached copy says the queue is full or empty,
+ * so both push and pop are wait-free.
+ * @tparam t1 type of key
+ * @tparam t2 type of info
+ */
+template<typename t1, typename t2>
+class SpscRingQueue {
+    /**
+     * Structure that holds an element of the queue
+     */
+    struct Element {
+        /**
+         * key
+         */
+        t1 key;
+        /**
+         * info
+         */
+        t2 info;
+    };
+
+    /**
+     * circular array of elements
+     */
+    Element *data;
+
+    /**
+     * capacity - 1, capacity is a power of two
+     */
+    size_t mask;
+
+    /**
+     * number of pushed elements, written by producer
+     */
+    alignas(CACHE_LINE) atomic<size_t> tail;
+
+    /**
+     * copy of head seen by producer
+     */
+    size_t cachedHead;
+
+    /**
+     * number of popped elements, written by consumer
+     */
+    alignas(CACHE_LINE) atomic<size_t> head;
+
+    /**
+     * copy of tail seen by consumer
+     */
+    size_t cachedTail;
+
+    /**
+     * padding, so that nothing else shares cache line of consumer
+     */
+    char padding[CACHE_LINE - sizeof(atomic<size_t>) - sizeof(size_t)];
+
+public:
+    /**
+     * Constructor with arguments
+     * @param capacity maximal number of elements, rounded up to a power of two
+     */
+    SpscRingQueue(size_t capacity) : tail(0), cachedHead(0), head(0), cachedTail(0) {
+        if (capacity == 0) throw std::invalid_argument("Queue capacity has to be greater than 0");
+        size_t size = 1;
+        while (size < capacity) size *= 2;
+        data = new Element[size];
+        mask = size - 1;
+    }
+
+    /**
+     * Queue is shared between threads, so it can not be copied
+     */
+    SpscRingQueue(const SpscRingQueue &) = delete;
+
+    /**
+     * Queue is shared between threads, so it can not be copied
+     */
+    SpscRingQueue &operator=(const SpscRingQueue &) = delete;
+
+    /**
+     * Destructor
+     */
+    ~SpscRingQueue() { delete[] data; }
+
+    /**
+     * Adds element at the end, may be called by producer only
+     * @param key key
+     * @param info info
+     * @return false if queue is full, true otherwise
+     */
+    bool push(const t1 &key, const t2 &info) {
+        size_t position = tail.load(memory_order_relaxed);
+        if (position - cachedHead > mask) {
+            cachedHead = head.load(memory_order_acquire);
+            if (position - cachedHead > mask) return false;
+        }
+        data[position & mask].key = key;
+        data[position & mask].info = info;
+        tail.store(position + 1, memory_order_release);
+        return true;
+    }
+
+    /**
+     * Adds as many elements as fit, publishing them at once, may be called by producer only
+     * @param keys keys
+     * @param infos infos
+     * @param count number of elements
+     * @return number of elements added
+     */
+    size_t pushBatch(const t1 *keys, const t2 *infos, size_t count) {
+        size_t position = tail.load(memory_order_relaxed);
+        size_t capacity = mask + 1;
+        if (capacity - (position - cachedHead) < count) cachedHead = head.load(memory_order_acquire);
+        size_t added = min(count, capacity - (position - cachedHead));
+        for (size_t i = 0; i < added; i++) {
+            data[(position + i) & mask].key = keys[i];
+            data[(position + i) & mask].info = infos[i];
+        }
+        tail.store(position + added, memory_order_release);
+        return added;
+    }
+
+    /**
+     * Removes first element, may be called by consumer only
+     * @param key key of removed element
+     * @param info info of removed element
+     * @return false if queue is empty, true otherwise
+     */
+    bool pop(t1 &key, t2 &info) {
+        size_t position = head.load(memory_order_relaxed);
+        if (position == cachedTail) {
+            cachedTail = tail.load(memory_order_acquire);
+            if (position == cachedTail) return false;
+        }
+        key = std::move(data[position & mask].key);
+        info = std::move(data[position & mask].info);
+        head.store(position + 1, memory_order_release);
+        return true;
+    }
+
+    /**
+     * Removes up to count first elements, releasing their slots at once, may be called by consumer only
+     * @param keys keys of removed elements
+     * @param infos infos of removed elements
+     * @param count maximal number of elements
+     * @return number of elements removed
+     */
+    size_t popBatch(t1 *keys, t2 *infos, size_t count) {
+        size_t position = head.load(memory_order_relaxed);
+        if (cachedTail - position < count) cachedTail = tail.load(memory_order_acquire);
+        size_t removed = min(count, cachedTail - position);
+        for (size_t i = 0; i < removed; i++) {
+            keys[i] = std::move(data[(position + i) & mask].key);
+            infos[i] = std::move(data[(position + i) & mask].info);
+        }
+        head.store(position + removed, memory_order_release);
+        return removed;
+    }
+
+    /**
+     * Returns number of elements, exact only if neither producer nor consumer runs
+     * @return number of elements
+     */
+    size_t size() const { return tail.load(memory_order_acquire) - head.load(memory_order_acquire); }
+
+    /**
+     * Returns maximal number of elements
+     * @return maximal number of elements
+     */
+    size_t capacity() const { return mask + 1; }
+};
+
+/**
+ * Fixed capacity ring queue for any number of producer and consumer threads. Every slot of the circular
+ * array has a sequence number telling whose turn it is: slot i is free for the push with ticket t when
+ * its sequence is t, and holds element for the pop with ticket t when its sequence is t + 1. Producers
+ * and consumers take tickets with compare-and-swap on tail and head, which sit on separate cache lines,
+ * and then touch only their own slots. Queue is lock-free.
+ * @tparam t1 type of key
+ * @tparam t2 type of info
+ */
+template<typename t1, typename t2>
+class MpmcRingQueue {
+    /**
+     * Structure that holds an element of the queue
+     */
+    struct Slot {
+        /**
+         * turn of the slot
+         */
+        atomic<size_t> sequence;
+        /**
+         * key
+         */
+        t1 key;
+        /**
+         * info
+         */
+        t2 info;
+    };
+
+    /**
+     * circular array of slots
+     */
+    Slot *slots;
+
+    /**
+     * capacity - 1, capacity is a power of two
+     */
+    size_t mask;
+
+    /**
+     * ticket of the next push
+     */
+    alignas(CACHE_LINE) atomic<size_t> tail;
+
+    /**
+     * ticket of the next pop
+     */
+    alignas(CACHE_LINE) atomic<size_t> head;
+
+    /**
+     * padding, so that nothing else shares cache line of consumers
+     */
+    char padding[CACHE_LINE - sizeof(atomic<size_t>)];
+
+    /**
+     * Reserves up to count consecutive tickets of tail or head whose slots are ready
+     * @param ticket tail or head
+     * @param count maximal number of tickets
+     * @param lag 0 for push, 1 for pop, sequence of a ready slot is its ticket + lag
+     * @param first first reserved ticket
+     * @return number of reserved tickets, 0 if queue is full or empty
+     */
+    size_t reserve(atomic<size_t> &ticket, size_t count, size_t lag, size_t &first) {
+        size_t position = ticket.load(memory_order_relaxed);
+        while (true) {
+            size_t ready = 0;
+            while (ready < count) {
+                size_t sequence = slots[(position + ready) & mask].sequence.load(memory_order_acquire);
+                if (sequence != position + ready + lag) break;
+                ready++;
+            }
+            if (ready == 0) {
+                size_t sequence = slots[position & mask].sequence.load(memory_order_acquire);
+                if ((ptrdiff_t) (sequence - (position + lag)) < 0) return 0;
+                position = ticket.load(memory_order_relaxed);
+                continue;
+            }
+            if (ticket.compare_exchange_weak(position, position + ready, memory_order_relaxed)) {
+                first = position;
+                return ready;
+            }
+        }
+    }
+
+public:
+    /**
+     * Constructor with arguments
+     * @param capacity maximal number of elements, rounded up to a power of two, at least 2
+     */
+    MpmcRingQueue(size_t capacity) : tail(0), head(0) {
+        if (capacity == 0) throw std::invalid_argument("Queue capacity has to be greater than 0");
+        size_t size = 2;
+        while (size < capacity) size *= 2;
+        slots = new Slot[size];
+        for (size_t i = 0; i < size; i++) slots[i].sequence.store(i, memory_order_relaxed);
+        mask = size - 1;
+    }
+
+    /**
+     * Queue is shared between threads, so it can not be copied
+     */
+    MpmcRingQueue(const MpmcRingQueue &) = delete;
+
+    /**
+     * Queue is shared between threads, so it can not be copied
+     */
+    MpmcRingQueue &operator=(const MpmcRingQueue &) = delete;
+
+    /**
+     * Destructor
+     */
+    ~MpmcRingQueue() { delete[] slots; }
+
+    /**
+     * Adds element at the end
+     * @param key key
+     * @param info info
+     * @return false if queue is full, true otherwise
+     */
+    bool push(const t1 &key, const t2 &info) { return pushBatch(&key, &info, 1) == 1; }
+
+    /**
+     * Adds up to count elements. Tickets for all of them are taken with a single compare-and-swap.
+     * @param keys keys
+     * @param infos infos
+     * @param count number of elements
+     * @return number of elements added, they are added in order and form a prefix of the arrays
+     */
+    size_t pushBatch(const t1 *keys, const t2 *infos, size_t count) {
+        size_t first;
+        size_t added = reserve(tail, count, 0, first);
+        for (size_t i = 0; i < added; i++) {
+            Slot &slot = slots[(first + i) & mask];
+            slot.key = keys[i];
+            slot.info = infos[i];
+            slot.sequence.store(first + i + 1, memory_order_release);
+        }
+        return added;
+    }
+
+    /**
+     * Removes first element
+     * @param key key of removed element
+     * @param info info of removed element
+     * @return false if queue is empty, true otherwise
+     */
+    bool pop(t1 &key, t2 &info) { return popBatch(&key, &info, 1) == 1; }
+
+    /**
+     * Removes up to count first elements. Tickets for all of them are taken with a single compare-and-swap.
+     * @param keys keys of removed elements
+     * @param infos infos of removed elements
+     * @param count maximal number of elements
+     * @return number of elements removed
+     */
+    size_t popBatch(t1 *keys, t2 *infos, size_t count) {
+        size_t first;
+        size_t removed = reserve(head, count, 1, first);
+        for (size_t i = 0; i < removed; i++) {
+            Slot &slot = slots[(first + i) & mask];
+            keys[i] = std::move(slot.key);
+            infos[i] = std::move(slot.info);
+            slot.sequence.store(first + i + mask + 1, memory_order_release);
+        }
+        return removed;
+    }
+
+    /**
+     * Returns number of elements, approximate while other threads push or pop
+     * @return number of elements
+     */
+    size_t size() const {
+        size_t pushed = tail.load(memory_order_acquire), popped = head.load(memory_order_acquire);
+        return pushed > popped ? pushed - popped : 0;
+    }
+
+    /**
+     * Returns maximal number of elements
+     * @return maximal number of elements
+     */
+    size_t capacity() const { return mask + 1; }
+};
+
+#endif //LAB_RINGQUEUE_CPP
@@ -2,18 +2,228 @@
 // Created by Michał Nowaliński on 17.10.2018.
 //
 
+#ifndef LAB_SEQUENCE_CPP
+#define LAB_SEQUENCE_CPP
+
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include "List.cpp"
 
+/**
+ * true if values of type T can be compared with operator <
+ */
+template<typename T, typename = void>
+struct HasLess : std::false_type {};
+
+template<typename T>
+struct HasLess<T, decltype(void(std::declval<const T &>() < std::declval<const T &>()))> : std::true_type {};
+
+/**
+ * Compares keys with operator <
+ * @tparam T type of key
+ * @return true if first key is less than second
+ */
+template<typename T>
+auto keyLess(const T &first, const T &second, int) -> decltype(bool(first < second)) { return first < second; }
+
+/**
+ * Never called, keys without operator < never make a sequence sorted
+ * @tparam T type of key
+ * @return false
+ */
+template<typename T>
+bool keyLess(const T &, const T &, long) { return false; }
+
 /**
  * Data structure that is used as an list adaptor.
+ * Key lookups return the first element with given key, counting from index 0. With key index enabled
+ * they cost O(1) on average instead of O(n).
+ * Copies of a sequence share its list and key index, both are copied on the first addElement to
+ * a sequence that shares them, so copies which are only read cost O(1).
+ * Sequence notices if its keys are in non-decreasing order while elements are added. Lookups in such
+ * sorted sequence use binary search and cost O(log n) without any extra memory, and two sorted
+ * sequences can be merged in O(n + m).
  * @tparam a0
  * @tparam a1
  */
 template <typename a0, typename a1>
 class Sequence {
+    /**
+     * Index from key to position of the first element with that key. It is used through this interface
+     * so that the hash of a0 is required only by sequences which enable the index.
+     */
+    struct KeyIndex {
+        virtual ~KeyIndex() {}
+
+        /**
+         * Creates empty index of the same kind
+         * @return new index
+         */
+        virtual KeyIndex *fresh() const = 0;
+
+        /**
+         * Adds position of element, if key is already in the index it keeps the earlier position
+         * @param key key of element
+         * @param position position of element
+         */
+        virtual void insert(const a0 &key, size_t position) = 0;
+
+        /**
+         * Looks for position of the first element with given key
+         * @param key key
+         * @param position found position
+         * @return true if key was found, false otherwise
+         */
+        virtual bool find(const a0 &key, size_t &position) const = 0;
+    };
+
+    /**
+     * KeyIndex kept in a hash table
+     * @tparam Hash hash of a0
+     */
+    template<typename Hash>
+    struct HashIndex : KeyIndex {
+        /**
+         * key to position map
+         */
+        std::unordered_map<a0, size_t, Hash> positions;
+
+        KeyIndex *fresh() const override { return new HashIndex(); }
+
+        void insert(const a0 &key, size_t position) override { positions.emplace(key, position); }
+
+        bool find(const a0 &key, size_t &position) const override {
+            auto it = positions.find(key);
+            if (it == positions.end()) return false;
+            position = it->second;
+            return true;
+        }
+    };
+
+    /**
+     * key index shared by copies of the sequence, nullptr if it is not enabled
+     */
+    std::shared_ptr<KeyIndex> index;
+
+    /**
+     * Replaces key index with a new one of given kind, built from elements of the list
+     * @param kind empty index of the kind to be built
+     */
+    void rebuild(KeyIndex *kind) {
+        index.reset(kind);
+        for (size_t i = 0; i < list.size(); ++i) index->insert(getList()[i].getKey(), i);
+    }
+
+    /**
+     * true if keys of the first verified elements are in non-decreasing order, only for keys with operator <
+     */
+    bool sorted = HasLess<a0>::value;
+
+    /**
+     * number of elements of the list sorted tells about
+     */
+    size_t verified = 0;
+
+    /**
+     * rewrites of the list when sorted was last brought up to date
+     */
+    size_t verifiedRewrites = 0;
+
+    /**
+     * Checks if sorted tells about the list as it is now
+     * @return true if the list has not been changed since sorted was brought up to date
+     */
+    bool current() const { return verifiedRewrites == list.getRewrites() && verified == list.size(); }
+
+    /**
+     * Brings sorted up to date with the list. Elements added to the end since the last update are compared
+     * with their predecessors, any other change of the list, also through list itself, makes all of them
+     * be compared again.
+     */
+    void verify() {
+        if (verifiedRewrites != list.getRewrites()) {
+            sorted = HasLess<a0>::value;
+            verified = 0;
+            verifiedRewrites = list.getRewrites();
+        }
+        const MyRing<a0, a1> &elements = getList();
+        for (size_t i = verified ? verified : 1; sorted && i < elements.size(); ++i)
+            if (keyLess(elements[i].getKey(), elements[i - 1].getKey(), 0)) sorted = false;
+        verified = elements.size();
+    }
+
+    /**
+     * Returns position of the first element in [from, to) of sorted list whose key is not less than key
+     * @param elements sorted list
+     * @param key key
+     * @param from first position
+     * @param to position after the last one
+     * @return found position, to if there is no such element
+     */
+    static size_t firstNotLess(const MyRing<a0, a1> &elements, const a0 &key, size_t from, size_t to) {
+        while (from < to) {
+            size_t middle = from + (to - from) / 2;
+            if (keyLess(elements[middle].getKey(), key, 0)) from = middle + 1;
+            else to = middle;
+        }
+        return from;
+    }
+
+    /**
+     * Returns position of the first element at or after from whose key is not less than key (greater than
+     * key if strict), searching in steps of growing length and then binary, so it costs O(log d) where d is
+     * the distance to found position
+     * @param elements sorted list
+     * @param key key
+     * @param from first position
+     * @param strict true to look for greater key instead of not less
+     * @return found position, size of the list if there is no such element
+     */
+    static size_t gallop(const MyRing<a0, a1> &elements, const a0 &key, size_t from, bool strict) {
+        auto before = [&](size_t position) {
+            const a0 &current = elements[position].getKey();
+            return strict ? !keyLess(key, current, 0) : keyLess(current, key, 0);
+        };
+        size_t size = elements.size(), step = 1, low = from;
+        while (low < size && before(low)) {
+            from = low + 1;
+            low += step;
+            step *= 2;
+        }
+        size_t high = low < size ? low : size;
+        while (from < high) {
+            size_t middle = from + (high - from) / 2;
+            if (before(middle)) from = middle + 1;
+            else high = middle;
+        }
+        return from;
+    }
+
+    /**
+     * Looks for position of the first element with given key, using index if it is enabled
+     * @param key key
+     * @param position found position
+     * @return true if key was found, false otherwise
+     */
+    bool lookup(const a0 &key, size_t &position) const {
+        if (index) return index->find(key, position);
+        if (sorted && current()) {
+            position = firstNotLess(list, key, 0, list.size());
+            return position < list.size() && list[position].getKey() == key;
+        }
+        for (position = 0; position < list.size(); ++position) if (list[position].getKey() == key) return true;
+        return false;
+    }
+
 public:
     /**
-     * list with keys and infos
+     * list with keys and infos. Elements added directly to the list, not by addElement, are not
+     * visible to key index until it is enabled again. Order of keys is checked again on the next lookup
+     * after the list was changed directly, for elements added to the end only they are checked.
      */
     MyRing<a0, a1> list;
 
@@ -21,13 +231,62 @@ public:
      * Constructor with arguments
      * @param elements elements
      */
-    Sequence(const MyRing<a0, a1> &elements) : list(elements) {}
+    Sequence(const MyRing<a0, a1> &elements) : list(elements) {
+        verify();
+    }
 
     /**
      * Default constructor
      */
     Sequence() = default;
 
+    /**
+     * Copying constructor, the copy shares list and key index with sequence. O(1)
+     * @param sequence sequence to be copied
+     */
+    Sequence(const Sequence &sequence) = default;
+
+    /**
+     * Overwritten operator =, key index of the sequence stays enabled or disabled as it was
+     * @param sequence sequence to be asigned
+     * @return reference to the sequence
+     */
+    Sequence &operator=(const Sequence &sequence) {
+        if (this == &sequence) return *this;
+        list = sequence.list;
+        if (sequence.verifiedRewrites == sequence.list.getRewrites()) {
+            sorted = sequence.sorted;
+            verified = sequence.verified;
+            verifiedRewrites = list.getRewrites();
+        }
+        verify();
+        if (index) rebuild(index->fresh());
+        return *this;
+    }
+
+    /**
+     * Enables key index, built from elements already in the list. getInfo and getElementByKy use it
+     * and cost O(1) on average. addElement keeps it up to date.
+     * @tparam Hash hash of a0
+     */
+    template<typename Hash = std::hash<a0>>
+    void enableIndex() {
+        rebuild(new HashIndex<Hash>());
+    }
+
+    /**
+     * Disables key index, key lookups scan the list again
+     */
+    void disableIndex() {
+        index.reset();
+    }
+
+    /**
+     * Checks if key index is enabled
+     * @return true if key index is enabled
+     */
+    bool isIndexed() const { return index != nullptr; }
+
     /**
      * Gets list
      * @return list
@@ -40,13 +299,12 @@ public:
     /**
      * Returns info corresponding to key provided as the argument
      * @param key key
-     * @return info associated with given key
+     * @return info of the first element with given key, a1() if there is no such element
      */
     a1 getInfo(a0 key) {
-        for (int i = 0; i < list.size(); ++i) {
-            if (list[i].getKey() == key) return list[i].getInfo();
-        }
-        return NULL;
+        verify();
+        size_t position;
+        return lookup(key, position) ? getList()[position].getInfo() : a1();
     }
 
     /**
@@ -55,7 +313,52 @@ public:
      * @param value value of the element
      */
     void addElement(a0 key, a1 value) {
+        if (index && index.use_count() > 1) rebuild(index->fresh());
         list.push_back(key, value);
+        verify();
+        if (index) index->insert(list.tail->key, list.size() - 1);
+    }
+
+    /**
+     * Checks if keys of elements are in non-decreasing order, so lookups use binary search
+     * @return true if sequence is sorted
+     */
+    bool isSorted() const {
+        if (current()) return sorted;
+        if (!HasLess<a0>::value) return false;
+        const MyRing<a0, a1> &elements = getList();
+        for (size_t i = 1; i < elements.size(); ++i)
+            if (keyLess(elements[i].getKey(), elements[i - 1].getKey(), 0)) return false;
+        return true;
+    }
+
+    /**
+     * Merges two sorted sequences into a new sorted one, elements with equal keys keep their order and
+     * elements of this sequence go before elements of the other one. Runs of elements taken from one
+     * sequence are found by galloping, so merging costs O(n + m) and fewer comparisons if keys of sequences
+     * do not interleave much.
+     * @param sequence sorted sequence to merge with
+     * @return merged sequence, without key index
+     */
+    Sequence merge(const Sequence &sequence) const {
+        if (!isSorted() || !sequence.isSorted()) throw std::invalid_argument("Only sorted sequences can be merged");
+        const MyRing<a0, a1> &mine = getList(), &theirs = sequence.getList();
+        Sequence merged;
+        size_t i = 0, j = 0;
+        while (i < mine.size() && j < theirs.size()) {
+            size_t end;
+            if (!keyLess(theirs[j].getKey(), mine[i].getKey(), 0)) {
+                for (end = gallop(mine, theirs[j].getKey(), i, true); i < end; ++i)
+                    merged.list.push_back(mine[i].key, mine[i].info);
+            } else {
+                for (end = gallop(theirs, mine[i].getKey(), j, false); j < end; ++j)
+                    merged.list.push_back(theirs[j].key, theirs[j].info);
+            }
+        }
+        for (; i < mine.size(); ++i) merged.list.push_back(mine[i].key, mine[i].info);
+        for (; j < theirs.size(); ++j) merged.list.push_back(theirs[j].key, theirs[j].info);
+        merged.verified = merged.list.size();
+        return merged;
     }
 
     /**
@@ -64,27 +367,39 @@ public:
      * @return element at given index
      */
     Element<a0,a1> getElement(int index) {
-        return list.at(index);
+        return getList().at(index);
     }
 
+    /**
+     * Gets element by key
+     * @param key key of the element
+     * @return the first element with given key
+     */
     Element<a0,a1> getElementByKy(a0 key) {
-        for(int i= 0;i < list.size(); i++) if(list.getElement(i).getKey() == key) return list.getElement();
-        return NULL;
+        verify();
+        size_t position;
+        if (!lookup(key, position)) throw std::invalid_argument("Sequence has no element with given key");
+        return getList().at(position);
     }
 
     /**
-     * Compares two sequences
+     * Compares two sequences. Sequences of different sizes or fingerprints are told unequal in O(1),
+     * otherwise elements are compared pairwise walking both lists, in O(n).
      * @param sequence sequence to compare
      * @return true if sequences are equal, false if they are not
      */
-    bool compare(Sequence sequence) {
-        int size = list.size();
-        if(sequence.getList().size() != size) return false;
-        for (int i = 0; i < size; ++i) {
-            if(list.at(i).getKey() != sequence.getList().at(i).getKey()) return false;
-            if(list.at(i).getInfo() != sequence.getList().at(i).getInfo()) return false;
+    bool compare(const Sequence &sequence) const {
+        size_t size = list.size();
+        if (sequence.getList().size() != size) return false;
+        if (list.getFingerprint() != sequence.getList().getFingerprint()) return false;
+        const Element<a0, a1> *mine = list.head, *theirs = sequence.getList().head;
+        for (size_t i = 0; i < size; ++i, mine = mine->next, theirs = theirs->next) {
+            if (mine->key != theirs->key) return false;
+            if (mine->info != theirs->info) return false;
         }
         return true;
     }
 
-};
\ No newline at end of file
+};
+
+#endif //LAB_SEQUENCE_CPP
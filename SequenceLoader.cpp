@@ -0,0 +1,360 @@
+#ifndef LAB_SEQUENCELOADER_CPP
+#define LAB_SEQUENCELOADER_CPP
+
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Sequence.cpp"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+/**
+ * Read-only view of characters kept somewhere else, usually in a MappedFile. It does not own the
+ * characters, so it is valid only as long as they are. Operators compare texts.
+ */
+class TextSlice {
+    /**
+     * first character
+     */
+    const char *begin;
+
+    /**
+     * number of characters
+     */
+    size_t length;
+
+public:
+    /**
+     * Default constructor, creates empty slice
+     */
+    TextSlice() : begin(nullptr), length(0) {}
+
+    /**
+     * Constructor with arguments
+     * @param begin first character
+     * @param length number of characters
+     */
+    TextSlice(const char *begin, size_t length) : begin(begin), length(length) {}
+
+    /**
+     * Returns first character
+     * @return pointer to the first character
+     */
+    const char *data() const { return begin; }
+
+    /**
+     * Returns number of characters
+     * @return number of characters
+     */
+    size_t size() const { return length; }
+
+    /**
+     * Returns true if slice has no characters
+     * @return true if slice has no characters
+     */
+    bool empty() const { return length == 0; }
+
+    /**
+     * Copies characters to a string
+     * @return string with characters of the slice
+     */
+    string str() const { return string(begin, length); }
+
+    bool operator==(const TextSlice &rhs) const {
+        return length == rhs.length && (length == 0 || memcmp(begin, rhs.begin, length) == 0);
+    }
+
+    bool operator!=(const TextSlice &rhs) const { return !(*this == rhs); }
+
+    bool operator<(const TextSlice &rhs) const {
+        size_t common = length < rhs.length ? length : rhs.length;
+        int order = common == 0 ? 0 : memcmp(begin, rhs.begin, common);
+        return order < 0 || (order == 0 && length < rhs.length);
+    }
+
+    bool operator>(const TextSlice &rhs) const { return rhs < *this; }
+
+    friend ostream &operator<<(ostream &os, const TextSlice &slice) {
+        return os.write(slice.begin, slice.length);
+    }
+};
+
+/**
+ * FNV-1a hash of characters of a slice, for Sequence::enableIndex<TextSliceHash>(). It is not std::hash,
+ * so that MyRing does not hash every info it is given to keep its fingerprint while a file is loaded.
+ */
+struct TextSliceHash {
+    size_t operator()(const TextSlice &slice) const {
+        size_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < slice.size(); i++) hash = (hash ^ (unsigned char) slice.data()[i]) * 1099511628211ull;
+        return hash;
+    }
+};
+
+/**
+ * File mapped to memory read-only. Slices of its text stay valid until the file is destroyed.
+ */
+class MappedFile {
+    /**
+     * first byte of the mapping, nullptr for empty file
+     */
+    char *mapping;
+
+    /**
+     * size of the file
+     */
+    size_t length;
+
+public:
+    /**
+     * Constructor with arguments, maps the whole file
+     * @param path path of the file
+     */
+    MappedFile(const string &path) : mapping(nullptr), length(0) {
+        int file = open(path.c_str(), O_RDONLY);
+        if (file < 0) throw runtime_error("MappedFile: could not open " + path);
+        struct stat status;
+        if (fstat(file, &status) != 0) {
+            close(file);
+            throw runtime_error("MappedFile: could not stat " + path);
+        }
+        length = (size_t) status.st_size;
+        if (length > 0) {
+            void *address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0);
+            if (address == MAP_FAILED) {
+                close(file);
+                throw runtime_error("MappedFile: could not map " + path);
+            }
+            mapping = static_cast<char *>(address);
+            madvise(mapping, length, MADV_SEQUENTIAL);
+        }
+        close(file);
+    }
+
+    /**
+     * Mapping is owned by one object, so it can not be copied
+     */
+    MappedFile(const MappedFile &) = delete;
+
+    /**
+     * Mapping is owned by one object, so it can not be copied
+     */
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * Destructor, unmaps the file
+     */
+    ~MappedFile() {
+        if (mapping) munmap(mapping, length);
+    }
+
+    /**
+     * Returns whole text of the file
+     * @return slice with all characters of the file
+     */
+    TextSlice text() const { return TextSlice(mapping, length); }
+
+    /**
+     * Returns size of the file
+     * @return size of the file in bytes
+     */
+    size_t size() const { return length; }
+};
+
+/**
+ * Returns first character in [from, to) that is equal to first or second, comparing 16 characters per
+ * step with SSE2 where the platform has it
+ * @param from first character
+ * @param to character after the last one
+ * @param first character to look for
+ * @param second other character to look for
+ * @return found character, to if there is none
+ */
+inline const char *findEither(const char *from, const char *to, char first, char second) {
+#ifdef __SSE2__
+    const __m128i firsts = _mm_set1_epi8(first), seconds = _mm_set1_epi8(second);
+    for (; to - from >= 16; from += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(from));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, firsts), _mm_cmpeq_epi8(block, seconds)));
+        if (mask != 0) return from + __builtin_ctz(mask);
+    }
+#endif
+    for (; from < to; ++from) if (*from == first || *from == second) return from;
+    return to;
+}
+
+/**
+ * Parses lines of form key, delimiter, info, newline. Empty lines are skipped and \r before newline
+ * is not part of info.
+ * @tparam Visit callable with (const TextSlice &key, const TextSlice &info)
+ * @param from first character
+ * @param to character after the last one
+ * @param delimiter character between key and info
+ * @param visit function called for every line
+ * @param last true if text after the last newline is a line too, false if it is left for the next call
+ * @return character after the last parsed line
+ */
+template<typename Visit>
+const char *parseLines(const char *from, const char *to, char delimiter, Visit &visit, bool last) {
+    while (from < to) {
+        const char *split = findEither(from, to, delimiter, '\n');
+        if (split == to && !last) return from;
+        if (split == to || *split == '\n') {
+            if (split == from || (split == from + 1 && *from == '\r')) {
+                from = split + (split < to);
+                continue;
+            }
+            throw invalid_argument("Line without delimiter: " + string(from, split));
+        }
+        const char *end = static_cast<const char *>(memchr(split + 1, '\n', to - split - 1));
+        if (end == nullptr) {
+            if (!last) return from;
+            end = to;
+        }
+        const char *infoEnd = end > split + 1 && end[-1] == '\r' ? end - 1 : end;
+        visit(TextSlice(from, split - from), TextSlice(split + 1, infoEnd - split - 1));
+        from = end + (end < to);
+    }
+    return from;
+}
+
+/**
+ * Converts text of a key to a key, slice is kept as it is
+ * @param text text of the key
+ * @param key converted key
+ */
+inline void parseKey(const TextSlice &text, TextSlice &key) { key = text; }
+
+/**
+ * Converts text of a key to a key, characters are copied to the string
+ * @param text text of the key
+ * @param key converted key
+ */
+inline void parseKey(const TextSlice &text, string &key) { key = text.str(); }
+
+/**
+ * Converts text of a key to an arithmetic key, throws if the whole text is not a number of type T.
+ * Leading whitespace and +, and - for unsigned T, are rejected, although strto* functions accept them.
+ * @tparam T arithmetic type of key
+ * @param text text of the key
+ * @param key converted key
+ */
+template<typename T>
+typename enable_if<is_arithmetic<T>::value>::type parseKey(const TextSlice &text, T &key) {
+    char buffer[64];
+    if (text.empty() || text.size() >= sizeof(buffer)) throw invalid_argument("Invalid number: " + text.str());
+    char first = text.data()[0];
+    if (isspace((unsigned char) first) || first == '+' || (first == '-' && !is_signed<T>::value))
+        throw invalid_argument("Invalid number: " + text.str());
+    memcpy(buffer, text.data(), text.size());
+    buffer[text.size()] = '\0';
+    char *end;
+    errno = 0;
+    if (is_floating_point<T>::value) {
+        long double value = strtold(buffer, &end);
+        // infinity and NaN written in text are kept, finite values out of range of T are rejected
+        if (isfinite(value) && fabsl(value) > (long double) numeric_limits<T>::max()) errno = ERANGE;
+        key = errno == 0 ? (T) value : T();
+    } else if (is_signed<T>::value) {
+        long long value = strtoll(buffer, &end, 10);
+        if (value < (long long) numeric_limits<T>::min() || value > (long long) numeric_limits<T>::max()) errno = ERANGE;
+        key = (T) value;
+    } else {
+        unsigned long long value = strtoull(buffer, &end, 10);
+        if (value > (unsigned long long) numeric_limits<T>::max()) errno = ERANGE;
+        key = (T) value;
+    }
+    if (errno != 0 || end != buffer + text.size()) throw invalid_argument("Invalid number: " + text.str());
+}
+
+/**
+ * Loads lines of a mapped file to the sequence, one element per line. Infos are slices of the file,
+ * nothing is copied but keys converted by parseKey, so the file has to outlive the sequence.
+ * @tparam a0 type of key, TextSlice, string or arithmetic
+ * @param file mapped file
+ * @param sequence sequence elements are added to
+ * @param delimiter character between key and info
+ * @return number of added elements
+ */
+template<typename a0>
+size_t loadSequence(const MappedFile &file, Sequence<a0, TextSlice> &sequence, char delimiter = '\t') {
+    size_t added = 0;
+    auto add = [&](const TextSlice &text, const TextSlice &info) {
+        a0 key;
+        parseKey(text, key);
+        sequence.addElement(key, info);
+        added++;
+    };
+    TextSlice text = file.text();
+    parseLines(text.data(), text.data() + text.size(), delimiter, add, true);
+    return added;
+}
+
+/**
+ * Reads lines of a file of any size, mapping window bytes at a time, so memory used does not depend on
+ * size of the file. Slices given to visit are valid only during the call, anything kept has to be copied.
+ * A window grows if a line does not fit in it.
+ * @tparam Visit callable with (const TextSlice &key, const TextSlice &info)
+ * @param path path of the file
+ * @param visit function called for every line
+ * @param delimiter character between key and info
+ * @param window number of bytes mapped at a time
+ * @return number of lines visited
+ */
+template<typename Visit>
+size_t streamFile(const string &path, Visit visit, char delimiter = '\t', size_t window = 64 << 20) {
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) throw runtime_error("streamFile: could not open " + path);
+    struct stat status;
+    if (fstat(file, &status) != 0) {
+        close(file);
+        throw runtime_error("streamFile: could not stat " + path);
+    }
+    size_t size = (size_t) status.st_size, page = (size_t) sysconf(_SC_PAGESIZE), offset = 0, visited = 0;
+    if (window < page) window = page;
+    auto counted = [&](const TextSlice &key, const TextSlice &info) {
+        visit(key, info);
+        visited++;
+    };
+    while (offset < size) {
+        size_t base = offset - offset % page, length = size - base < window ? size - base : window;
+        void *address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, (off_t) base);
+        if (address == MAP_FAILED) {
+            close(file);
+            throw runtime_error("streamFile: could not map " + path);
+        }
+        madvise(address, length, MADV_SEQUENTIAL);
+        const char *mapping = static_cast<const char *>(address), *from = mapping + (offset - base);
+        const char *stop;
+        try {
+            stop = parseLines(from, mapping + length, delimiter, counted, base + length == size);
+        } catch (...) {
+            munmap(address, length);
+            close(file);
+            throw;
+        }
+        munmap(address, length);
+        if (stop == from) window *= 2;
+        offset += stop - from;
+    }
+    close(file);
+    return visited;
+}
+
+#endif //LAB_SEQUENCELOADER_CPP
@@ -0,0 +1,186 @@
+#ifndef LAB_STRINGPOOL_CPP
+#define LAB_STRINGPOOL_CPP
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+class StringPool;
+
+/**
+ * Handle to a string kept in a StringPool. Every distinct string is stored in the pool exactly once,
+ * so two handles from the same pool are equal if and only if they point to the same entry.
+ * Operators == and != compare pointers only, so AVLTree::searchValue and operator() compare values
+ * in O(1) each. Handle counts references, string is removed from the pool when the last handle to
+ * it is destroyed.
+ * Pool has to outlive all handles created by it.
+ */
+class InternedString {
+    friend class StringPool;
+
+    typedef unordered_map<string, size_t>::value_type Entry;
+
+    /**
+     * pool that owns the entry
+     */
+    StringPool *pool;
+
+    /**
+     * entry in the pool, pair of text and number of references
+     */
+    Entry *entry;
+
+    /**
+     * Constructor with arguments, used by pool only
+     * @param pool pool that owns the entry
+     * @param entry entry in the pool
+     */
+    InternedString(StringPool *pool, Entry *entry) : pool(pool), entry(entry) {
+        if (entry) entry->second++;
+    }
+
+    /**
+     * Drops reference to the entry
+     */
+    inline void release();
+
+public:
+    /**
+     * Default constructor, creates handle to empty string that does not belong to any pool
+     */
+    InternedString() : pool(nullptr), entry(nullptr) {}
+
+    /**
+     * Copying constructor
+     * @param cc handle to be copied
+     */
+    InternedString(const InternedString &cc) : pool(cc.pool), entry(cc.entry) {
+        if (entry) entry->second++;
+    }
+
+    /**
+     * Destructor
+     */
+    ~InternedString() { release(); }
+
+    /**
+     * Overwritten operator =
+     * @param rhs handle to be asigned
+     * @return reference to the handle
+     */
+    InternedString &operator=(const InternedString &rhs) {
+        if (entry == rhs.entry) return *this;
+        if (rhs.entry) rhs.entry->second++;
+        release();
+        pool = rhs.pool;
+        entry = rhs.entry;
+        return *this;
+    }
+
+    /**
+     * Returns text of the handle
+     * @return text, empty string for default constructed handle
+     */
+    const string &str() const {
+        static const string empty;
+        return entry ? entry->first : empty;
+    }
+
+    /**
+     * Returns number of handles pointing to the same string
+     * @return number of handles
+     */
+    size_t references() const { return entry ? entry->second : 0; }
+
+    /**
+     * Overwritten operator ==, compares pointers
+     * @param rhs handle to be compared
+     * @return true if handles point to the same string, false otherwise
+     */
+    bool operator==(const InternedString &rhs) const { return entry == rhs.entry; }
+
+    /**
+     * Overwritten operator !=, compares pointers
+     * @param rhs handle to be compared
+     * @return false if handles point to the same string, true otherwise
+     */
+    bool operator!=(const InternedString &rhs) const { return entry != rhs.entry; }
+
+    /**
+     * Friend function used to printing handle using cout
+     * @param output output
+     * @param show handle
+     * @return ostream
+     */
+    friend ostream &operator<<(ostream &output, const InternedString &show) {
+        output << show.str();
+        return output;
+    }
+};
+
+/**
+ * Pool of reference counted strings. Used to keep repeated string values of containers only once,
+ * for example AVLTree<int, InternedString> instead of AVLTree<int, string>.
+ */
+class StringPool {
+    friend class InternedString;
+
+    /**
+     * texts with number of handles pointing to them
+     */
+    unordered_map<string, size_t> entries;
+
+public:
+    /**
+     * Default constructor
+     */
+    StringPool() = default;
+
+    /**
+     * Handles point into the pool, so it can not be copied
+     */
+    StringPool(const StringPool &) = delete;
+
+    /**
+     * Handles point into the pool, so it can not be copied
+     */
+    StringPool &operator=(const StringPool &) = delete;
+
+    /**
+     * Returns handle to given text, text is added to the pool if it is not there yet
+     * @param text text
+     * @return handle to the text
+     */
+    InternedString intern(const string &text) {
+        auto inserted = entries.emplace(text, 0);
+        return InternedString(this, &*inserted.first);
+    }
+
+    /**
+     * Returns handle to given text without adding it to the pool. Useful for lookups, returned handle
+     * is not equal to any handle in the pool if text is not there.
+     * @param text text
+     * @return handle to the text or default constructed handle
+     */
+    InternedString find(const string &text) {
+        auto found = entries.find(text);
+        return found == entries.end() ? InternedString() : InternedString(this, &*found);
+    }
+
+    /**
+     * Returns number of distinct strings in the pool
+     * @return number of distinct strings
+     */
+    size_t size() const { return entries.size(); }
+};
+
+void InternedString::release() {
+    if (entry && --entry->second == 0) pool->entries.erase(pool->entries.find(entry->first));
+    entry = nullptr;
+    pool = nullptr;
+}
+
+#endif //LAB_STRINGPOOL_CPP
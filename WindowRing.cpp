@@ -0,0 +1,278 @@
+#ifndef LAB_WINDOWRING_CPP
+#define LAB_WINDOWRING_CPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+/**
+ * Ring of fixed capacity that keeps the last capacity elements pushed to it. When it is full, pushing
+ * overwrites the oldest element. Sum, minimum and maximum of infos in the window are maintained while
+ * pushing: sum is updated in O(1), minimum and maximum are kept with monotonic deques, which hold
+ * positions of elements that can still become minimum (maximum) of the window, in increasing order of
+ * info (decreasing for maximum). Every element enters and leaves each deque at most once, so push is
+ * O(1) amortised and queries are O(1).
+ * @tparam t1 type of key, for example time of sample
+ * @tparam t2 type of info, it needs to have overwritten operators: +, -, <, >, =
+ */
+template<typename t1, typename t2>
+class WindowRing {
+    /**
+     * Structure that holds an element of the ring
+     */
+    struct Element {
+        /**
+         * key
+         */
+        t1 key;
+        /**
+         * info
+         */
+        t2 info;
+    };
+
+    /**
+     * Deque of positions of elements, kept in circular array of window's capacity
+     */
+    struct Deque {
+        /**
+         * positions of elements
+         */
+        size_t *positions;
+        /**
+         * index of the first position
+         */
+        size_t first;
+        /**
+         * number of positions
+         */
+        size_t count;
+    };
+
+    /**
+     * circular array of elements
+     */
+    Element *data;
+
+    /**
+     * maximal number of elements
+     */
+    size_t maxSize;
+
+    /**
+     * number of elements pushed so far, element number p is kept at index p % maxSize
+     */
+    size_t pushed;
+
+    /**
+     * number of elements in the window
+     */
+    size_t count;
+
+    /**
+     * sum of infos in the window
+     */
+    t2 total;
+
+    /**
+     * positions of candidates for minimum, infos increasing
+     */
+    Deque minimal;
+
+    /**
+     * positions of candidates for maximum, infos decreasing
+     */
+    Deque maximal;
+
+    /**
+     * Returns info of element with given position
+     * @param position position of element
+     * @return info
+     */
+    const t2 &infoAt(size_t position) const { return data[position % maxSize].info; }
+
+    /**
+     * Drops front of the deque if it is the element that leaves the window
+     * @param deque deque
+     * @param position position of element that leaves the window
+     */
+    void expire(Deque &deque, size_t position) {
+        if (deque.count > 0 && deque.positions[deque.first] == position) {
+            deque.first = (deque.first + 1) % maxSize;
+            deque.count--;
+        }
+    }
+
+    /**
+     * Adds position of new element at the back of the deque, dropping positions of elements which can
+     * no longer be the extreme because new element is better and stays in the window longer
+     * @tparam Better comparator
+     * @param deque deque
+     * @param position position of new element
+     * @param better returns true if first info is strictly better than second
+     */
+    template<typename Better>
+    void enter(Deque &deque, size_t position, Better better) {
+        const t2 &info = infoAt(position);
+        while (deque.count > 0 && !better(infoAt(deque.positions[(deque.first + deque.count - 1) % maxSize]), info))
+            deque.count--;
+        deque.positions[(deque.first + deque.count) % maxSize] = position;
+        deque.count++;
+    }
+
+public:
+    /**
+     * Constructor with arguments
+     * @param capacity number of elements kept, has to be greater than 0
+     */
+    WindowRing(size_t capacity) : maxSize(capacity), pushed(0), count(0), total() {
+        if (capacity == 0) throw std::invalid_argument("Window capacity has to be greater than 0");
+        data = new Element[capacity];
+        minimal.positions = new size_t[capacity];
+        maximal.positions = new size_t[capacity];
+        minimal.first = minimal.count = maximal.first = maximal.count = 0;
+    }
+
+    /**
+     * Copying constructor
+     * @param cc window to be copied
+     */
+    WindowRing(const WindowRing &cc) : WindowRing(cc.maxSize) {
+        for (size_t i = 0; i < cc.count; i++) push(cc.getKey(i), cc.getInfo(i));
+    }
+
+    /**
+     * Overwritten operator =
+     * @param rhs window to be asigned
+     * @return reference to the window
+     */
+    WindowRing &operator=(const WindowRing &rhs) {
+        if (this == &rhs) return *this;
+        WindowRing copy(rhs);
+        std::swap(data, copy.data);
+        std::swap(minimal, copy.minimal);
+        std::swap(maximal, copy.maximal);
+        maxSize = copy.maxSize;
+        pushed = copy.pushed;
+        count = copy.count;
+        total = copy.total;
+        return *this;
+    }
+
+    /**
+     * Destructor
+     */
+    ~WindowRing() {
+        delete[] data;
+        delete[] minimal.positions;
+        delete[] maximal.positions;
+    }
+
+    /**
+     * Adds element as the newest one, if window is full the oldest element is overwritten
+     * @param key key
+     * @param info info
+     */
+    void push(const t1 &key, const t2 &info) {
+        if (count == maxSize) {
+            size_t oldest = pushed - maxSize;
+            total = total - infoAt(oldest);
+            expire(minimal, oldest);
+            expire(maximal, oldest);
+            count--;
+        }
+        Element &element = data[pushed % maxSize];
+        element.key = key;
+        element.info = info;
+        total = total + info;
+        enter(minimal, pushed, [](const t2 &kept, const t2 &added) { return kept < added; });
+        enter(maximal, pushed, [](const t2 &kept, const t2 &added) { return kept > added; });
+        pushed++;
+        count++;
+    }
+
+    /**
+     * Removes all elements
+     */
+    void clear() {
+        pushed = count = 0;
+        total = t2();
+        minimal.first = minimal.count = maximal.first = maximal.count = 0;
+    }
+
+    /**
+     * Returns key of element
+     * @param index 0 for the oldest element, size() - 1 for the newest
+     * @return key
+     */
+    const t1 &getKey(size_t index) const { return data[(pushed - count + index) % maxSize].key; }
+
+    /**
+     * Returns info of element
+     * @param index 0 for the oldest element, size() - 1 for the newest
+     * @return info
+     */
+    const t2 &getInfo(size_t index) const { return data[(pushed - count + index) % maxSize].info; }
+
+    /**
+     * Returns sum of infos in the window. For floating point infos it is kept by adding and subtracting,
+     * so it carries rounding error of all elements that passed through the window.
+     * @return sum of infos, t2() if window is empty
+     */
+    t2 sum() const { return total; }
+
+    /**
+     * Returns minimal info in the window
+     * @return minimal info
+     */
+    const t2 &min() const {
+        if (count == 0) throw std::runtime_error("Window is empty");
+        return infoAt(minimal.positions[minimal.first]);
+    }
+
+    /**
+     * Returns maximal info in the window
+     * @return maximal info
+     */
+    const t2 &max() const {
+        if (count == 0) throw std::runtime_error("Window is empty");
+        return infoAt(maximal.positions[maximal.first]);
+    }
+
+    /**
+     * Returns mean of infos in the window
+     * @return sum divided by number of elements
+     */
+    double mean() const {
+        if (count == 0) throw std::runtime_error("Window is empty");
+        return (double) total / count;
+    }
+
+    /**
+     * Returns number of elements
+     * @return number of elements
+     */
+    size_t size() const { return count; }
+
+    /**
+     * Returns maximal number of elements
+     * @return maximal number of elements
+     */
+    size_t capacity() const { return maxSize; }
+
+    /**
+     * Returns true is window is empty
+     * @return true is window is empty
+     */
+    bool isEmpty() const { return count == 0; }
+
+    /**
+     * Returns true is window is full, next push overwrites the oldest element
+     * @return true is window is full
+     */
+    bool isFull() const { return count == maxSize; }
+};
+
+#endif //LAB_WINDOWRING_CPP
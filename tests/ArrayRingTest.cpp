@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <utility>
+#include "Check.cpp"
+#include "ArrayRing.cpp"
+
+typedef pair<int, int> Pair;
+typedef Ring<int, int, ArrayStorage> ArrayRing;
+typedef Ring<int, int, InlineStorage<8>> InlineRing;
+
+/**
+ * Returns keys and infos of the ring from the first element
+ * @tparam R type of ring
+ * @param ring ring
+ * @return elements in order
+ */
+template<typename R>
+deque<Pair> elements(const R &ring) {
+    deque<Pair> result;
+    auto it = ring.constBegin();
+    for (size_t i = 0; i < ring.size(); i++, ++it) result.emplace_back(it->key, it->info);
+    return result;
+}
+
+/**
+ * Runs random additions, removals, rotations and reversals on the ring and on a deque doing the same,
+ * and compares them after every operation
+ * @tparam R type of ring
+ * @param seed seed of the generator
+ * @param operations number of operations
+ * @return number of operations after which ring and deque differed
+ */
+template<typename R>
+int compareWithDeque(unsigned seed, int operations) {
+    mt19937 random(seed);
+    R ring;
+    deque<Pair> model;
+    int next = 0, wrong = 0;
+    for (int i = 0; i < operations; i++) {
+        switch (random() % 8) {
+            case 0:
+            case 1:
+                ring.addEnd(next, -next);
+                model.emplace_back(next, -next);
+                next++;
+                break;
+            case 2:
+                ring.addBegin(next, -next);
+                model.insert(model.empty() ? model.end() : model.begin() + 1, Pair(next, -next));
+                next++;
+                break;
+            case 3:
+                if (!model.empty()) {
+                    int key = model[random() % model.size()].first;
+                    ring.remove(key);
+                    model.erase(find(model.begin(), model.end(), Pair(key, -key)));
+                }
+                break;
+            case 4:
+            case 5:
+            case 6: {
+                long steps = (long) (random() % 7) - 3;
+                if (random() % 4 == 0) steps *= (long) model.size() / 2 + 1;
+                ring.rotate(steps);
+                if (!model.empty()) {
+                    long shift = steps % (long) model.size();
+                    if (shift < 0) shift += model.size();
+                    std::rotate(model.begin(), model.begin() + shift, model.end());
+                }
+                break;
+            }
+            default:
+                ring.reverse();
+                std::reverse(model.begin(), model.end());
+        }
+        if (elements(ring) != model) wrong++;
+    }
+    return wrong;
+}
+
+/**
+ * Rotated ring laid out again by later additions and removals keeps its order, whichever side of the
+ * rotation point is moved, whether the array is full or not and whether it is inline
+ */
+void testRandomOperations() {
+    for (unsigned seed = 1; seed <= 20; seed++) {
+        CHECK(compareWithDeque<ArrayRing>(seed, 600) == 0);
+        CHECK(compareWithDeque<InlineRing>(seed, 600) == 0);
+    }
+}
+
+/**
+ * Round-robin use, rotating by one and then adding and removing an element, keeps every element once
+ */
+void testRoundRobin() {
+    const int COUNT = 1000;
+    ArrayRing ring;
+    deque<Pair> model;
+    for (int i = 0; i < COUNT; i++) {
+        ring.addEnd(i, -i);
+        model.emplace_back(i, -i);
+    }
+    int wrong = 0;
+    for (int i = 0; i < 3 * COUNT; i++) {
+        ring.rotate(1);
+        std::rotate(model.begin(), model.begin() + 1, model.end());
+        ring.remove(model.front().first);
+        model.pop_front();
+        ring.addEnd(COUNT + i, -(COUNT + i));
+        model.emplace_back(COUNT + i, -(COUNT + i));
+        if (i % 97 == 0 && elements(ring) != model) wrong++;
+    }
+    CHECK(wrong == 0);
+    CHECK(elements(ring) == model);
+}
+
+int main() {
+    testRandomOperations();
+    testRoundRobin();
+    return finish();
+}
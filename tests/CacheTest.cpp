@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <list>
+#include <random>
+#include <utility>
+#include "Check.cpp"
+#include "Cache.cpp"
+
+typedef Cache<int, int> IntCache;
+
+/**
+ * LRU evicts the entry that was not used for the longest time, hits and updates make entries recent
+ */
+void testLru() {
+    IntCache cache(3, IntCache::LRU);
+    cache.put(1, 10);
+    cache.put(2, 20);
+    cache.put(3, 30);
+    CHECK(cache.get(1) != nullptr && *cache.get(1) == 10);
+    cache.put(4, 40);
+    CHECK(!cache.contains(2) && cache.contains(1) && cache.contains(3) && cache.contains(4));
+    cache.put(3, 33);
+    cache.put(5, 50);
+    CHECK(!cache.contains(1) && *cache.get(3) == 33);
+    CHECK(cache.size() == 3 && cache.capacity() == 3);
+    CHECK(cache.getHits() == 3 && cache.getMisses() == 0 && cache.getEvictions() == 2);
+    CHECK(cache.get(2) == nullptr && cache.getMisses() == 1);
+}
+
+/**
+ * CLOCK gives referenced entries a second chance: the hand clears their bits and evicts the first
+ * entry that was not referenced since the hand passed it
+ */
+void testClock() {
+    IntCache cache(3, IntCache::CLOCK);
+    cache.put(1, 10);
+    cache.put(2, 20);
+    cache.put(3, 30);
+    cache.get(1);
+    cache.put(4, 40);
+    CHECK(!cache.contains(2) && cache.contains(1) && cache.contains(3) && cache.contains(4));
+    cache.get(3);
+    cache.get(1);
+    cache.put(5, 50);
+    CHECK(!cache.contains(4) && cache.contains(1) && cache.contains(3));
+    cache.put(6, 60);
+    CHECK(!cache.contains(3) && cache.contains(1) && cache.contains(5) && cache.contains(6));
+    CHECK(cache.getHits() == 3 && cache.getEvictions() == 3);
+}
+
+/**
+ * getOrCompute computes only missing values, remove and clear keep statistics and resetStatistics
+ * clears them
+ */
+void testStatistics() {
+    IntCache cache(2);
+    int computed = 0;
+    auto compute = [&computed](const int &key) {
+        computed++;
+        return key * 100;
+    };
+    CHECK(cache.getOrCompute(1, compute) == 100);
+    CHECK(cache.getOrCompute(1, compute) == 100);
+    CHECK(cache.getOrCompute(2, compute) == 200);
+    CHECK(cache.getOrCompute(3, compute) == 300);
+    CHECK(computed == 3);
+    CHECK(cache.getHits() == 1 && cache.getMisses() == 3 && cache.getEvictions() == 1);
+    cache.remove(3);
+    CHECK(cache.size() == 1 && !cache.contains(3));
+    cache.clear();
+    CHECK(cache.size() == 0 && cache.getMisses() == 3);
+    cache.resetStatistics();
+    CHECK(cache.getHits() == 0 && cache.getMisses() == 0 && cache.getEvictions() == 0);
+    CHECK_THROWS(IntCache(0), invalid_argument);
+}
+
+/**
+ * Compares random gets, puts and removes with a list-based model of the policy
+ * @param policy replacement policy
+ * @return number of operations after which cache and model differed
+ */
+int compareWithModel(IntCache::Policy policy) {
+    const size_t CAPACITY = 16;
+    mt19937 random(26);
+    IntCache cache(CAPACITY, policy);
+    list<pair<int, bool>> model;
+    auto hand = model.end();
+    size_t evictions = 0;
+    int wrong = 0;
+    auto locate = [&model](int key) {
+        auto same = [key](const pair<int, bool> &entry) { return entry.first == key; };
+        return find_if(model.begin(), model.end(), same);
+    };
+    for (int i = 0; i < 20000; i++) {
+        int key = (int) (random() % 40), operation = (int) (random() % 10);
+        auto found = locate(key);
+        if (operation < 5) {
+            bool hit = cache.get(key) != nullptr;
+            wrong += hit != (found != model.end());
+            if (found != model.end()) {
+                if (policy == IntCache::LRU) model.splice(model.begin(), model, found);
+                else found->second = true;
+            }
+        } else if (operation < 9) {
+            cache.put(key, key);
+            if (found != model.end()) {
+                if (policy == IntCache::LRU) model.splice(model.begin(), model, found);
+                else found->second = true;
+                continue;
+            }
+            if (model.size() == CAPACITY) {
+                evictions++;
+                if (policy == IntCache::LRU) {
+                    model.pop_back();
+                } else {
+                    while (hand->second) {
+                        hand->second = false;
+                        if (++hand == model.end()) hand = model.begin();
+                    }
+                    hand = model.erase(hand);
+                    if (hand == model.end()) hand = model.begin();
+                }
+            }
+            if (policy == IntCache::LRU) {
+                model.emplace_front(key, false);
+            } else {
+                bool empty = model.empty();
+                model.emplace(hand, key, false);
+                if (empty) hand = model.begin();
+            }
+        } else {
+            cache.remove(key);
+            if (found != model.end()) {
+                if (found == hand && ++hand == model.end()) hand = model.begin();
+                model.erase(found);
+                if (model.empty()) hand = model.end();
+            }
+        }
+        wrong += cache.size() != model.size() || cache.getEvictions() != evictions;
+    }
+    for (int key = 0; key < 40; key++) wrong += cache.contains(key) != (locate(key) != model.end());
+    return wrong;
+}
+
+/**
+ * Long random runs keep the same entries as models of LRU and CLOCK
+ */
+void testRandomOperations() {
+    CHECK(compareWithModel(IntCache::LRU) == 0);
+    CHECK(compareWithModel(IntCache::CLOCK) == 0);
+}
+
+int main() {
+    testLru();
+    testClock();
+    testStatistics();
+    testRandomOperations();
+    return finish();
+}
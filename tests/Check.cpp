@@ -0,0 +1,107 @@
+#ifndef LAB_CHECK_CPP
+#define LAB_CHECK_CPP
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <ftw.h>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * Returns number of failed checks
+ * @return reference to the counter
+ */
+inline int &failures() {
+    static int count = 0;
+    return count;
+}
+
+/**
+ * Reports failed check, the test goes on so that all failures are printed
+ * @param passed result of the check
+ * @param condition text of the check
+ * @param file file of the check
+ * @param line line of the check
+ */
+inline void check(bool passed, const char *condition, const char *file, int line) {
+    if (passed) return;
+    cerr << file << ":" << line << ": check failed: " << condition << endl;
+    failures()++;
+}
+
+/**
+ * Checks condition, unlike assert it works with NDEBUG too
+ */
+#define CHECK(condition) check((condition), #condition, __FILE__, __LINE__)
+
+/**
+ * Checks that statement throws exception of given type
+ */
+#define CHECK_THROWS(statement, Exception)                                   \
+    do {                                                                     \
+        bool thrown = false;                                                 \
+        try {                                                                \
+            statement;                                                       \
+        } catch (const Exception &) {                                        \
+            thrown = true;                                                   \
+        }                                                                    \
+        check(thrown, #statement " throws " #Exception, __FILE__, __LINE__); \
+    } while (0)
+
+/**
+ * Returns exit code of the test
+ * @return 0 if all checks passed, 1 otherwise
+ */
+inline int finish() {
+    if (failures() > 0) cerr << failures() << " checks failed" << endl;
+    return failures() > 0 ? 1 : 0;
+}
+
+/**
+ * Empty directory for files of a test, removed with its content when the test ends
+ */
+class TemporaryDirectory {
+    /**
+     * path of the directory
+     */
+    string path;
+
+    /**
+     * Removes one entry, called for every entry under the directory, deepest first
+     */
+    static int removeEntry(const char *name, const struct stat *, int, struct FTW *) { return remove(name); }
+
+public:
+    /**
+     * Default constructor, creates the directory
+     */
+    TemporaryDirectory() {
+        char name[] = "/tmp/labtestXXXXXX";
+        if (!mkdtemp(name)) {
+            cerr << "could not create temporary directory" << endl;
+            exit(1);
+        }
+        path = name;
+    }
+
+    TemporaryDirectory(const TemporaryDirectory &) = delete;
+
+    TemporaryDirectory &operator=(const TemporaryDirectory &) = delete;
+
+    /**
+     * Destructor, removes the directory
+     */
+    ~TemporaryDirectory() { nftw(path.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS); }
+
+    /**
+     * Returns path of a file in the directory
+     * @param name name of the file
+     * @return path of the file
+     */
+    string file(const string &name) const { return path + "/" + name; }
+};
+
+#endif //LAB_CHECK_CPP
@@ -0,0 +1,133 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+#include "Check.cpp"
+#include "ColumnSequence.cpp"
+
+/**
+ * Returns position of the first key equal to key, comparing one key at a time with ==
+ * @tparam a0 type of key
+ * @param keys keys
+ * @param count number of keys
+ * @param key key to look for
+ * @return position of the first equal key, count if there is no such key
+ */
+template<typename a0>
+size_t scalarScan(const a0 *keys, size_t count, const a0 &key) {
+    for (size_t i = 0; i < count; ++i) if (keys[i] == key) return i;
+    return count;
+}
+
+/**
+ * Compares scanKeys with a scalar scan for keys at every position of columns of every length up to three
+ * vectors, starting at every offset so loads are not aligned, and for keys that are not there. Keys differ
+ * from each other in high bytes only, so a lane that compared only a part of a key would match.
+ * @tparam a0 type of key
+ * @param random generator
+ * @return number of wrong results
+ */
+template<typename a0>
+int compareWithScalar(mt19937 &random) {
+    const size_t lanes = 16 / sizeof(a0), longest = 3 * lanes + 3;
+    vector<a0> values;
+    for (int i = 0; i < 6; i++) {
+        uint64_t bits = sizeof(a0) == 1 ? (uint64_t) i : (uint64_t) i << (8 * sizeof(a0) - 8);
+        a0 value;
+        if (std::is_floating_point<a0>::value) value = (a0) (i + 1) * (a0) 1e10;
+        else std::memcpy(&value, &bits, sizeof(a0));
+        values.push_back(value);
+    }
+    int wrong = 0;
+    vector<a0> column(longest + lanes);
+    for (size_t offset = 0; offset < lanes; offset++) {
+        for (size_t count = 0; count <= longest; count++) {
+            a0 *keys = column.data() + offset;
+            for (size_t i = 0; i < count; i++) keys[i] = values[random() % 4];
+            for (const a0 &key : values)
+                wrong += scanKeys(keys, count, key, 0) != scalarScan(keys, count, key);
+            for (size_t position = 0; position < count; position++) {
+                a0 kept = keys[position];
+                keys[position] = values[5];
+                wrong += scanKeys(keys, count, values[5], 0) != scalarScan(keys, count, values[5]);
+                keys[position] = kept;
+            }
+        }
+    }
+    return wrong;
+}
+
+/**
+ * SIMD scans of every lane width and of floating point keys agree with a scalar scan
+ */
+void testLaneWidths() {
+    mt19937 random(47);
+    CHECK(compareWithScalar<int8_t>(random) == 0);
+    CHECK(compareWithScalar<uint8_t>(random) == 0);
+    CHECK(compareWithScalar<char>(random) == 0);
+    CHECK(compareWithScalar<int16_t>(random) == 0);
+    CHECK(compareWithScalar<uint16_t>(random) == 0);
+    CHECK(compareWithScalar<int32_t>(random) == 0);
+    CHECK(compareWithScalar<uint32_t>(random) == 0);
+    CHECK(compareWithScalar<int64_t>(random) == 0);
+    CHECK(compareWithScalar<uint64_t>(random) == 0);
+    CHECK(compareWithScalar<float>(random) == 0);
+    CHECK(compareWithScalar<double>(random) == 0);
+}
+
+/**
+ * 64-bit keys equal to the wanted one in one 32-bit half only are not found
+ */
+void testHalfEqualKeys() {
+    const int64_t wanted = 0x0000000500000007LL;
+    vector<int64_t> keys = {0x0000000600000007LL, 0x0000000500000008LL, 7, 0x0000000500000000LL, wanted, 5};
+    CHECK(scanKeys(keys.data(), keys.size(), wanted, 0) == 4);
+    CHECK(scanKeys(keys.data(), 4, wanted, 0) == 4);
+    CHECK(scanKeys(keys.data(), keys.size(), (int64_t) 5, 0) == 5);
+}
+
+/**
+ * Floating point keys compare as by ==: NaN is never found and 0.0 and -0.0 find each other
+ */
+template<typename a0>
+void checkFloatingPoint() {
+    const a0 nan = numeric_limits<a0>::quiet_NaN();
+    vector<a0> keys = {1, nan, (a0) -0.0, 3, nan, (a0) 0.0, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, nan};
+    CHECK(scanKeys(keys.data(), keys.size(), nan, 0) == keys.size());
+    CHECK(scanKeys(keys.data(), keys.size(), (a0) 0.0, 0) == 2);
+    CHECK(scanKeys(keys.data(), keys.size(), (a0) -0.0, 0) == 2);
+    CHECK(scanKeys(keys.data(), keys.size(), (a0) 17, 0) == 16);
+    CHECK(scanKeys(keys.data(), keys.size(), numeric_limits<a0>::infinity(), 0) == keys.size());
+}
+
+/**
+ * NaN and signed zero of float and double keys
+ */
+void testFloatingPoint() {
+    checkFloatingPoint<float>();
+    checkFloatingPoint<double>();
+}
+
+/**
+ * Sequence finds the first element with given key and rejects missing keys and positions
+ */
+void testSequence() {
+    ColumnSequence<short, int> sequence;
+    for (int i = 0; i < 100; i++) sequence.addElement((short) (i % 30), i);
+    CHECK(sequence.size() == 100);
+    CHECK(sequence.getInfo(29) == 29 && sequence.getInfo(5) == 5);
+    CHECK(sequence.getInfo(31) == 0);
+    CHECK(sequence.getElementByKy(7).getInfo() == 7);
+    CHECK(sequence.getElement(99).getKey() == 9);
+    CHECK_THROWS(sequence.getElementByKy(30), invalid_argument);
+    CHECK_THROWS(sequence.getElement(100), out_of_range);
+}
+
+int main() {
+    testLaneWidths();
+    testHalfEqualKeys();
+    testFloatingPoint();
+    testSequence();
+    return finish();
+}
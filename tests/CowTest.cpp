@@ -0,0 +1,170 @@
+#include <string>
+#include <vector>
+#include "Check.cpp"
+#include "Sequence.cpp"
+
+typedef MyRing<int, string> Ring;
+
+/**
+ * Returns keys of the list walking it from head, as iterations over the list do
+ * @param ring list
+ * @return keys
+ */
+vector<int> keys(const Ring &ring) {
+    vector<int> result;
+    const Element<int, string> *element = ring.head;
+    for (size_t i = 0; i < ring.size(); i++, element = element->next) result.push_back(element->key);
+    return result;
+}
+
+/**
+ * Returns keys 0 ... count - 1
+ * @param count number of keys
+ * @return keys
+ */
+vector<int> range(int count) {
+    vector<int> result;
+    for (int i = 0; i < count; i++) result.push_back(i);
+    return result;
+}
+
+/**
+ * Creates list with elements 0 ... count - 1, spanning several chunks
+ * @param count number of elements
+ * @return list
+ */
+Ring filled(int count) {
+    Ring ring;
+    for (int i = 0; i < count; i++) ring.push_back(i, to_string(i));
+    return ring;
+}
+
+/**
+ * Elements added to a copy or to the original are not seen by the other one
+ */
+void testPushBack() {
+    const int COUNT = 1000;
+    Ring original = filled(COUNT), copy(original);
+    size_t fingerprint = original.getFingerprint();
+    copy.push_back(COUNT, "copy");
+    CHECK(original.size() == COUNT && keys(original) == range(COUNT));
+    CHECK(original.getFingerprint() == fingerprint);
+    CHECK(copy.size() == COUNT + 1 && copy.tail->key == COUNT);
+    original.push_back(-1, "original");
+    CHECK(original.tail->key == -1 && copy.tail->key == COUNT);
+    CHECK(keys(copy)[COUNT - 1] == COUNT - 1);
+}
+
+/**
+ * Elements changed through front, at and [] of a copy stay unchanged in the original, and the other way
+ */
+void testWrites() {
+    const int COUNT = 300;
+    Ring original = filled(COUNT), copy(original);
+    size_t fingerprint = original.getFingerprint();
+    copy.front().info = "front";
+    copy.at(100).info = "at";
+    copy[COUNT - 1].info = "index";
+    const Ring &constOriginal = original;
+    CHECK(constOriginal.front().info == "0");
+    CHECK(constOriginal.at(100).info == "100");
+    CHECK(constOriginal[COUNT - 1].info == to_string(COUNT - 1));
+    CHECK(original.getFingerprint() == fingerprint);
+    CHECK(copy.at(100).info == "at" && copy.getFingerprint() != fingerprint);
+    Ring assigned;
+    assigned = original;
+    original[5].info = "original";
+    CHECK(static_cast<const Ring &>(assigned)[5].info == "5");
+    CHECK(assigned.getFingerprint() == fingerprint);
+}
+
+/**
+ * Clearing a copy does not clear the original, and the other way
+ */
+void testClear() {
+    const int COUNT = 500;
+    Ring original = filled(COUNT), copy(original), other;
+    other = original;
+    copy.clear();
+    CHECK(copy.empty() && copy.head == nullptr);
+    CHECK(keys(original) == range(COUNT));
+    original.clear();
+    CHECK(original.empty());
+    CHECK(keys(other) == range(COUNT));
+    copy.push_back(7, "7");
+    CHECK(copy.size() == 1 && other.size() == COUNT);
+}
+
+/**
+ * Elements added to a copy of an indexed sequence are found by the copy only, and the index of the
+ * original still finds its own elements
+ */
+void testIndexedSequence() {
+    Sequence<int, string> original;
+    original.enableIndex();
+    for (int i = 0; i < 100; i++) original.addElement(i, to_string(i));
+    Sequence<int, string> copy(original);
+    CHECK(copy.isIndexed());
+    copy.addElement(1000, "copy");
+    CHECK(copy.getInfo(1000) == "copy");
+    CHECK(original.getInfo(1000).empty());
+    CHECK_THROWS(original.getElementByKy(1000), invalid_argument);
+    original.addElement(2000, "original");
+    CHECK(original.getInfo(2000) == "original");
+    CHECK(copy.getInfo(2000).empty());
+    CHECK(original.getInfo(50) == "50" && copy.getInfo(50) == "50");
+    CHECK(original.getList().size() == 101 && copy.getList().size() == 101);
+    Sequence<int, string> assigned;
+    assigned.enableIndex();
+    assigned = original;
+    assigned.addElement(3000, "assigned");
+    CHECK(assigned.getInfo(2000) == "original" && assigned.getInfo(3000) == "assigned");
+    CHECK(original.getInfo(3000).empty());
+}
+
+/**
+ * A copy that stops being sorted does not make the original unsorted
+ */
+void testSortedSequence() {
+    Sequence<int, string> original;
+    for (int i = 0; i < 100; i++) original.addElement(i * 2, to_string(i));
+    Sequence<int, string> copy(original);
+    copy.addElement(-1, "copy");
+    CHECK(!copy.isSorted() && original.isSorted());
+    CHECK(original.getInfo(40) == "20" && copy.getInfo(-1) == "copy");
+    CHECK(!original.compare(copy));
+}
+
+/**
+ * A reference returned by non-const access before a copy was made changes the original only
+ */
+void testReferenceBeforeCopy() {
+    const int COUNT = 200;
+    Ring original = filled(COUNT);
+    Element<int, string> &first = original.at(0), &middle = original[100], &front = original.front();
+    Ring copy(original), assigned;
+    assigned = original;
+    first.info = "changed";
+    middle.info = "changed";
+    front.key = -1;
+    const Ring &constCopy = copy, &constAssigned = assigned;
+    CHECK(constCopy.at(0).info == "0" && constCopy.front().key == 0 && constCopy[100].info == "100");
+    CHECK(constAssigned.at(0).info == "0" && constAssigned[100].info == "100");
+    CHECK(keys(copy) == range(COUNT) && keys(assigned) == range(COUNT));
+    CHECK(original.front().info == "changed" && original.front().key == -1);
+    CHECK(copy.getFingerprint() == filled(COUNT).getFingerprint());
+    original.clear();
+    original.push_back(1, "1");
+    Ring shared(original);
+    CHECK(shared.head == original.head);
+}
+
+int main() {
+    testPushBack();
+    testWrites();
+    testClear();
+    testReferenceBeforeCopy();
+    testIndexedSequence();
+    testSortedSequence();
+    return finish();
+}
@@ -0,0 +1,151 @@
+#include <csignal>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+#include "Check.cpp"
+#include "DurableTree.cpp"
+
+typedef DurableTree<int, int> Tree;
+
+/**
+ * size of a log record of Tree: type, payload length, key, value and checksum
+ */
+const off_t RECORD = 1 + 4 + 4 + 4 + 4;
+
+/**
+ * Returns size of a file
+ * @param path path of the file
+ * @return size in bytes
+ */
+off_t fileSize(const string &path) {
+    struct stat status;
+    return stat(path.c_str(), &status) == 0 ? status.st_size : -1;
+}
+
+/**
+ * Inserted and removed keys survive reopening, from snapshot and from log written after it
+ */
+void testReopen() {
+    TemporaryDirectory directory;
+    string path = directory.file("tree");
+    {
+        Tree tree(path);
+        for (int i = 0; i < 100; i++) tree.insert(i, i * 10);
+        for (int i = 0; i < 100; i += 2) tree.remove(i);
+        tree.checkpoint();
+        for (int i = 100; i < 110; i++) tree.insert(i, i * 10);
+        tree.remove(1);
+    }
+    Tree tree(path);
+    int value = 0;
+    for (int i = 0; i < 110; i++) CHECK(tree.contains(i) == (i >= 100 || (i % 2 == 1 && i != 1)));
+    CHECK(tree.get(55, value) && value == 550);
+}
+
+/**
+ * A record cut in the middle of writing is dropped, records before it are kept and the log is cut
+ * behind them, so records added later are not hidden behind the torn one
+ */
+void testTruncatedTail() {
+    TemporaryDirectory directory;
+    string path = directory.file("tree");
+    {
+        Tree tree(path);
+        for (int i = 0; i < 10; i++) tree.insert(i, i);
+    }
+    CHECK(fileSize(path + ".log") == 10 * RECORD);
+    CHECK(truncate((path + ".log").c_str(), 10 * RECORD - 3) == 0);
+    {
+        Tree tree(path);
+        for (int i = 0; i < 9; i++) CHECK(tree.contains(i));
+        CHECK(!tree.contains(9));
+        tree.insert(20, 20);
+    }
+    Tree tree(path);
+    for (int i = 0; i < 9; i++) CHECK(tree.contains(i));
+    CHECK(!tree.contains(9));
+    CHECK(tree.contains(20));
+}
+
+/**
+ * A record whose checksum does not match is dropped together with everything behind it
+ */
+void testCorruptedTail() {
+    TemporaryDirectory directory;
+    string path = directory.file("tree");
+    {
+        Tree tree(path);
+        for (int i = 0; i < 10; i++) tree.insert(i, i);
+    }
+    FILE *log = fopen((path + ".log").c_str(), "r+b");
+    CHECK(log != nullptr);
+    if (!log) return;
+    fseek(log, 9 * RECORD + 1 + 4 + 4, SEEK_SET);
+    fputc(0x7f, log);
+    fclose(log);
+    Tree tree(path);
+    for (int i = 0; i < 9; i++) CHECK(tree.contains(i));
+    CHECK(!tree.contains(9));
+}
+
+/**
+ * When the log can not be written, the mutation throws, every later mutation throws too, and
+ * reopening gives exactly the mutations that returned
+ */
+void testFailedFlush() {
+    TemporaryDirectory directory;
+    string path = directory.file("tree");
+    signal(SIGXFSZ, SIG_IGN);
+    struct rlimit original;
+    getrlimit(RLIMIT_FSIZE, &original);
+    int acknowledged = 0;
+    {
+        Tree tree(path);
+        for (; acknowledged < 10; acknowledged++) tree.insert(acknowledged, acknowledged);
+        struct rlimit limited = original;
+        limited.rlim_cur = 10 * RECORD + RECORD / 2;
+        setrlimit(RLIMIT_FSIZE, &limited);
+        CHECK_THROWS(tree.insert(acknowledged, acknowledged), runtime_error);
+        setrlimit(RLIMIT_FSIZE, &original);
+        CHECK_THROWS(tree.insert(100, 100), runtime_error);
+        CHECK_THROWS(tree.remove(0), runtime_error);
+        CHECK_THROWS(tree.checkpoint(), runtime_error);
+    }
+    CHECK(fileSize(path + ".log") == 10 * RECORD);
+    Tree tree(path);
+    for (int i = 0; i < acknowledged; i++) CHECK(tree.contains(i));
+    CHECK(!tree.contains(acknowledged));
+    CHECK(!tree.contains(100));
+    tree.insert(100, 100);
+    CHECK(tree.contains(100));
+}
+
+/**
+ * Mutations of many threads sharing group commits are all on disk after they return
+ */
+void testConcurrentInserts() {
+    TemporaryDirectory directory;
+    string path = directory.file("tree");
+    const int THREADS = 4, EACH = 200;
+    {
+        Tree tree(path);
+        vector<thread> workers;
+        for (int t = 0; t < THREADS; t++)
+            workers.emplace_back([&tree, t] { for (int i = 0; i < EACH; i++) tree.insert(t * EACH + i, t); });
+        for (thread &worker : workers) worker.join();
+    }
+    CHECK(fileSize(path + ".log") == THREADS * EACH * RECORD);
+    Tree tree(path);
+    int value = -1;
+    for (int i = 0; i < THREADS * EACH; i++) CHECK(tree.get(i, value) && value == i / EACH);
+}
+
+int main() {
+    testReopen();
+    testTruncatedTail();
+    testCorruptedTail();
+    testFailedFlush();
+    testConcurrentInserts();
+    return finish();
+}
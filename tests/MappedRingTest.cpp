@@ -0,0 +1,166 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Check.cpp"
+#include "MappedRing.cpp"
+
+typedef MappedRing<int64_t, int64_t> Log;
+
+/**
+ * size of a record of Log: sequence, checksum with padding, key and info
+ */
+const size_t RECORD = 8 + 8 + 8 + 8;
+
+/**
+ * offsets of fields of the header
+ */
+const off_t TAIL = 32, SYNCED = 40;
+
+/**
+ * Returns keys of the ring from the first element
+ * @param ring ring
+ * @return keys
+ */
+vector<int64_t> keys(const Log &ring) {
+    vector<int64_t> result;
+    auto it = ring.constBegin();
+    for (size_t i = 0; i < ring.size(); i++, ++it) result.push_back(it->key);
+    return result;
+}
+
+/**
+ * Returns keys from first to last, inclusive
+ * @param first the first key
+ * @param last the last key
+ * @return keys
+ */
+vector<int64_t> range(int64_t first, int64_t last) {
+    vector<int64_t> result;
+    for (int64_t key = first; key <= last; key++) result.push_back(key);
+    return result;
+}
+
+/**
+ * Creates ring with elements 0 ... count - 1
+ * @param path path of the file
+ * @param capacity capacity of the ring
+ * @param count number of elements
+ */
+void fill(const string &path, size_t capacity, int64_t count) {
+    Log ring(path, capacity);
+    for (int64_t i = 0; i < count; i++) ring.addEnd(i, i * 10);
+}
+
+/**
+ * Overwrites 8 bytes of the file
+ * @param path path of the file
+ * @param offset offset of the bytes
+ * @param value new value
+ */
+void overwrite(const string &path, off_t offset, uint64_t value) {
+    int fd = open(path.c_str(), O_WRONLY);
+    CHECK(fd >= 0 && pwrite(fd, &value, sizeof(value), offset) == (ssize_t) sizeof(value));
+    if (fd >= 0) close(fd);
+}
+
+/**
+ * Makes the file look like the header was last flushed when tail was synced, while records behind it
+ * reached the disk, as after a crash between flushing records and the header
+ * @param path path of the file
+ * @param synced tail at the last sync
+ */
+void crashAfter(const string &path, uint64_t synced) {
+    overwrite(path, TAIL, synced);
+    overwrite(path, SYNCED, synced);
+}
+
+/**
+ * Returns offset of the record of element
+ * @param capacity capacity of the ring
+ * @param position number of the element
+ * @return offset in the file
+ */
+off_t recordOffset(size_t capacity, uint64_t position) {
+    return (off_t) ((size_t) sysconf(_SC_PAGESIZE) + position % capacity * RECORD);
+}
+
+/**
+ * Records written after the last sync are recovered if they are whole
+ */
+void testRollForward() {
+    TemporaryDirectory directory;
+    string path = directory.file("ring");
+    fill(path, 16, 10);
+    crashAfter(path, 5);
+    Log ring(path, 16);
+    CHECK(keys(ring) == range(0, 9));
+    CHECK(ring.getGeneration() == 2);
+}
+
+/**
+ * A torn record ends the ring, valid records behind it are erased so they do not come back later
+ */
+void testTornRecord() {
+    TemporaryDirectory directory;
+    string path = directory.file("ring");
+    fill(path, 16, 10);
+    crashAfter(path, 5);
+    overwrite(path, recordOffset(16, 7) + 24, 12345);
+    {
+        Log ring(path, 16);
+        CHECK(keys(ring) == range(0, 6));
+        ring.addEnd(100, 1000);
+    }
+    crashAfter(path, 5);
+    Log ring(path, 16);
+    vector<int64_t> expected = range(0, 6);
+    expected.push_back(100);
+    CHECK(keys(ring) == expected);
+}
+
+/**
+ * A record that was never written ends the ring
+ */
+void testMissingRecord() {
+    TemporaryDirectory directory;
+    string path = directory.file("ring");
+    fill(path, 16, 10);
+    crashAfter(path, 5);
+    overwrite(path, recordOffset(16, 9), 0);
+    Log ring(path, 16);
+    CHECK(keys(ring) == range(0, 8));
+}
+
+/**
+ * Recovery of a ring that wrapped keeps only elements whose records are still theirs: 17 is torn, and
+ * 18 and 19, written before the crash, took records of 10 and 11
+ */
+void testWrappedTornRecord() {
+    TemporaryDirectory directory;
+    string path = directory.file("ring");
+    fill(path, 8, 20);
+    crashAfter(path, 14);
+    overwrite(path, recordOffset(8, 17) + 16, 777);
+    Log ring(path, 8);
+    CHECK(keys(ring) == range(12, 16));
+}
+
+/**
+ * A file cut shorter than its header says is rejected instead of being mapped
+ */
+void testTruncatedFile() {
+    TemporaryDirectory directory;
+    string path = directory.file("ring");
+    fill(path, 16, 10);
+    CHECK(truncate(path.c_str(), recordOffset(16, 5)) == 0);
+    CHECK_THROWS(Log ring(path, 16), runtime_error);
+}
+
+int main() {
+    testRollForward();
+    testTornRecord();
+    testMissingRecord();
+    testWrappedTornRecord();
+    testTruncatedFile();
+    return finish();
+}
@@ -0,0 +1,108 @@
+#include <thread>
+#include <vector>
+#include "Check.cpp"
+#include "Parallel.cpp"
+
+/**
+ * Checks that segments cover the ring exactly once, in order of iteration from the first element
+ * @tparam R type of ring
+ * @tparam Segment type of segments
+ * @param ring ring
+ * @param segments segments of the ring
+ * @param parts number of segments asked for
+ * @return true if segments are correct
+ */
+template<typename R, typename Segment>
+bool covers(const R &ring, const vector<Segment> &segments, size_t parts) {
+    size_t expected = parts < ring.size() ? parts : ring.size();
+    if (segments.size() != expected) return false;
+    auto it = ring.constBegin();
+    size_t visited = 0;
+    for (const Segment &segment : segments) {
+        if (segment.length == 0) return false;
+        auto element = segment.first;
+        for (size_t i = 0; i < segment.length; i++, ++element, ++it, ++visited)
+            if (element->key != it->key) return false;
+    }
+    return visited == ring.size();
+}
+
+/**
+ * Segments of linked and array rings of many sizes cover them exactly once, whether the ring is reversed
+ * or not and whether skip markers were left by an earlier call or not
+ */
+void testSegmentCoverage() {
+    const size_t sizes[] = {1, 2, 15, 100, 1000, 5000};
+    const size_t parts[] = {1, 2, 3, 7, 64, 2000};
+    for (size_t size : sizes) {
+        Ring<int, int> linked;
+        Ring<int, int, ArrayStorage> array;
+        for (size_t i = 0; i < size; i++) {
+            linked.addEnd((int) i, 1);
+            array.addEnd((int) i, 1);
+        }
+        for (int reversed = 0; reversed < 2; reversed++) {
+            const Ring<int, int> &constLinked = linked;
+            const Ring<int, int, ArrayStorage> &constArray = array;
+            for (size_t part : parts) {
+                CHECK(covers(linked, constLinked.segments(part), part));
+                CHECK(covers(linked, linked.segments(part), part));
+                CHECK(covers(linked, constLinked.segments(part), part));
+                CHECK(covers(array, array.segments(part), part));
+                CHECK(covers(array, constArray.segments(part), part));
+            }
+            CHECK(constLinked.segments(0).empty() && constArray.segments(0).empty());
+            linked.reverse();
+            array.reverse();
+        }
+    }
+    const Ring<int, int> empty;
+    CHECK(empty.segments(4).empty());
+}
+
+/**
+ * Parallel reduction gives the same result as a sequential fold, also when many reductions run over
+ * the same ring at once
+ */
+void testReduce() {
+    const int COUNT = 20000, THREADS = 4;
+    Ring<int, int> ring;
+    long long expected = 0;
+    for (int i = 0; i < COUNT; i++) {
+        ring.addEnd(i, i % 13);
+        expected += (long long) i * (i % 13);
+    }
+    const Ring<int, int> &constRing = ring;
+    auto map = [](const int &key, const int &info) { return (long long) key * info; };
+    auto combine = [](long long a, long long b) { return a + b; };
+    CHECK(parallelReduce(constRing, 0LL, map, combine, 3) == expected);
+    vector<long long> results(THREADS);
+    vector<thread> readers;
+    for (int t = 0; t < THREADS; t++)
+        readers.emplace_back([&, t] { results[t] = parallelReduce(constRing, 0LL, map, combine, 2 + t); });
+    for (thread &reader : readers) reader.join();
+    for (long long result : results) CHECK(result == expected);
+    Ring<int, int> empty;
+    CHECK(parallelReduce(empty, 7LL, map, combine) == 7);
+}
+
+/**
+ * Parallel for each visits every element once and may change infos
+ */
+void testForEach() {
+    const int COUNT = 10000;
+    Ring<int, int, ArrayStorage> ring;
+    for (int i = 0; i < COUNT; i++) ring.addEnd(i, 0);
+    parallelForEach(ring, [](const int &key, int &info) { info += key + 1; }, 4);
+    auto it = ring.constBegin();
+    int wrong = 0;
+    for (int i = 0; i < COUNT; i++, ++it) wrong += it->info != it->key + 1;
+    CHECK(wrong == 0);
+}
+
+int main() {
+    testSegmentCoverage();
+    testReduce();
+    testForEach();
+    return finish();
+}
@@ -0,0 +1,64 @@
+#include <random>
+#include "Check.cpp"
+#include "Ring.cpp"
+
+/**
+ * Fills three rings with the same random elements, with many equal keys, one ring without index, one
+ * with key index and one with ordered index
+ * @param random generator
+ * @param plain ring without index
+ * @param hashed ring with key index
+ * @param ordered ring with ordered index
+ */
+void fill(mt19937 &random, Ring<int, int> &plain, Ring<int, int> &hashed, Ring<int, int> &ordered) {
+    hashed.enableIndex();
+    ordered.enableOrderedIndex();
+    for (int i = 0; i < 2000; i++) {
+        int key = (int) (random() % 50);
+        if (random() % 3 == 0) {
+            plain.addBegin(key, i);
+            hashed.addBegin(key, i);
+            ordered.addBegin(key, i);
+        } else {
+            plain.addEnd(key, i);
+            hashed.addEnd(key, i);
+            ordered.addEnd(key, i);
+        }
+    }
+}
+
+/**
+ * Finding and removing keys that are in the ring many times act on the same element, the first one
+ * counting from head, whichever index is enabled
+ */
+void testDuplicates() {
+    mt19937 random(39);
+    Ring<int, int> plain, hashed, ordered;
+    fill(random, plain, hashed, ordered);
+    int wrong = 0;
+    for (int round = 0; round < 1500; round++) {
+        int key = (int) (random() % 55);
+        auto expected = plain.find(key);
+        auto byHash = hashed.find(key), byOrder = ordered.find(key);
+        if (expected == Ring<int, int>::RingIterator()) {
+            wrong += byHash != Ring<int, int>::RingIterator() || byOrder != Ring<int, int>::RingIterator();
+        } else {
+            wrong += byHash->info != expected->info || byOrder->info != expected->info;
+        }
+        plain.remove(key);
+        hashed.remove(key);
+        ordered.remove(key);
+        if (round % 10 == 0) {
+            plain.rotate(round);
+            hashed.rotate(round);
+            ordered.rotate(round);
+        }
+    }
+    CHECK(wrong == 0);
+    CHECK(plain.size() == hashed.size() && plain.size() == ordered.size());
+}
+
+int main() {
+    testDuplicates();
+    return finish();
+}
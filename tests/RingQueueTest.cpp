@@ -0,0 +1,109 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "Check.cpp"
+#include "RingQueue.cpp"
+
+/**
+ * Every element pushed by many producers is popped exactly once by many consumers, and elements of
+ * one producer are popped by each consumer in order they were pushed
+ */
+void testMpmcCounts() {
+    const int PRODUCERS = 4, CONSUMERS = 4, EACH = 50000;
+    MpmcRingQueue<int, int> queue(64);
+    vector<atomic<int>> seen(PRODUCERS * EACH);
+    for (atomic<int> &count : seen) count.store(0);
+    atomic<int> popped(0), outOfOrder(0);
+    vector<thread> threads;
+    for (int p = 0; p < PRODUCERS; p++) {
+        threads.emplace_back([&queue, p] {
+            int keys[8], infos[8];
+            for (int i = 0; i < EACH;) {
+                if (i % 3 == 0) {
+                    if (queue.push(p, i)) i++;
+                    else this_thread::yield();
+                    continue;
+                }
+                int batch = 0;
+                for (; batch < 8 && i + batch < EACH; batch++) {
+                    keys[batch] = p;
+                    infos[batch] = i + batch;
+                }
+                size_t pushed = queue.pushBatch(keys, infos, batch);
+                if (pushed == 0) this_thread::yield();
+                i += (int) pushed;
+            }
+        });
+    }
+    for (int c = 0; c < CONSUMERS; c++) {
+        threads.emplace_back([&, c] {
+            vector<int> last(PRODUCERS, -1);
+            int keys[8], infos[8];
+            while (popped.load() < PRODUCERS * EACH) {
+                size_t count = c % 2 ? queue.popBatch(keys, infos, 8) : queue.pop(keys[0], infos[0]);
+                if (count == 0) {
+                    this_thread::yield();
+                    continue;
+                }
+                for (size_t i = 0; i < count; i++) {
+                    seen[keys[i] * EACH + infos[i]]++;
+                    if (infos[i] <= last[keys[i]]) outOfOrder++;
+                    last[keys[i]] = infos[i];
+                }
+                popped += (int) count;
+            }
+        });
+    }
+    for (thread &worker : threads) worker.join();
+    CHECK(popped.load() == PRODUCERS * EACH);
+    CHECK(outOfOrder.load() == 0);
+    int wrong = 0;
+    for (atomic<int> &count : seen) wrong += count.load() != 1;
+    CHECK(wrong == 0);
+    int key, info;
+    CHECK(!queue.pop(key, info));
+}
+
+/**
+ * Single producer and single consumer see elements in order, whole batches or not
+ */
+void testSpscOrder() {
+    const int COUNT = 200000;
+    SpscRingQueue<int, int> queue(32);
+    thread producer([&queue] {
+        for (int i = 0; i < COUNT;) {
+            if (queue.push(i, -i)) i++;
+            else this_thread::yield();
+        }
+    });
+    int expected = 0, wrong = 0;
+    int keys[16], infos[16];
+    while (expected < COUNT) {
+        size_t count = queue.popBatch(keys, infos, 16);
+        if (count == 0) this_thread::yield();
+        for (size_t i = 0; i < count; i++, expected++) wrong += keys[i] != expected || infos[i] != -expected;
+    }
+    producer.join();
+    CHECK(wrong == 0);
+    int key, info;
+    CHECK(!queue.pop(key, info));
+}
+
+/**
+ * Full queue refuses push and empty queue refuses pop
+ */
+void testBounds() {
+    MpmcRingQueue<int, int> queue(3);
+    int pushed = 0, key, info;
+    while (queue.push(pushed, pushed)) pushed++;
+    CHECK(pushed == 4);
+    for (int i = 0; i < pushed; i++) CHECK(queue.pop(key, info) && key == i);
+    CHECK(!queue.pop(key, info));
+}
+
+int main() {
+    testBounds();
+    testSpscOrder();
+    testMpmcCounts();
+    return finish();
+}
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+#include "Check.cpp"
+#include "ArrayRing.cpp"
+
+typedef pair<int, int> Pair;
+typedef Ring<int, int> LinkedRing;
+typedef Ring<int, int, ArrayStorage> ArrayRing;
+
+/**
+ * Compares pairs by keys only
+ */
+bool keyLess(const Pair &a, const Pair &b) { return a.first < b.first; }
+
+/**
+ * Returns keys and infos of the ring from the first element
+ * @tparam R type of ring
+ * @param ring ring
+ * @return elements in order
+ */
+template<typename R>
+vector<Pair> elements(const R &ring) {
+    vector<Pair> result;
+    auto it = ring.constBegin();
+    for (size_t i = 0; i < ring.size(); i++, ++it) result.emplace_back(it->key, it->info);
+    return result;
+}
+
+/**
+ * Creates ring of given elements, reversed or rotated so that its links do not follow its order
+ * @tparam R type of ring
+ * @param pairs elements in order the ring has to have
+ * @param layout 0 to add elements in order, 1 to reverse the ring, 2 to rotate it
+ * @return ring
+ */
+template<typename R>
+R makeRing(const vector<Pair> &pairs, int layout) {
+    R ring;
+    if (layout == 1) {
+        for (size_t i = pairs.size(); i > 0; i--) ring.addEnd(pairs[i - 1].first, pairs[i - 1].second);
+        ring.reverse();
+    } else if (layout == 2 && !pairs.empty()) {
+        size_t shift = pairs.size() / 3;
+        for (size_t i = 0; i < pairs.size(); i++) {
+            const Pair &pair = pairs[(i + pairs.size() - shift) % pairs.size()];
+            ring.addEnd(pair.first, pair.second);
+        }
+        ring.rotate((long) shift);
+    } else {
+        for (const Pair &pair : pairs) ring.addEnd(pair.first, pair.second);
+    }
+    return ring;
+}
+
+/**
+ * Returns random elements with keys in [0, keys) and unique infos starting at first
+ * @param random generator
+ * @param count number of elements
+ * @param keys number of different keys
+ * @param first info of the first element
+ * @return elements
+ */
+vector<Pair> randomPairs(mt19937 &random, size_t count, int keys, int first) {
+    vector<Pair> result;
+    for (size_t i = 0; i < count; i++) result.emplace_back((int) (random() % keys), first + (int) i);
+    return result;
+}
+
+/**
+ * Sorts random rings of every layout and compares them with std::stable_sort
+ * @tparam R type of ring
+ * @return number of wrong results
+ */
+template<typename R>
+int checkSort() {
+    mt19937 random(42);
+    const size_t sizes[] = {0, 1, 2, 3, 17, 64, 500};
+    int wrong = 0;
+    for (size_t size : sizes) {
+        for (int layout = 0; layout < 3; layout++) {
+            vector<Pair> pairs = randomPairs(random, size, size > 4 ? (int) size / 4 : 2, 0);
+            R ring = makeRing<R>(pairs, layout);
+            ring.sort();
+            stable_sort(pairs.begin(), pairs.end(), keyLess);
+            wrong += elements(ring) != pairs;
+        }
+    }
+    return wrong;
+}
+
+/**
+ * Merges random sorted rings of every layout and compares them with std::stable_sort of both, elements
+ * of this ring first
+ * @tparam R type of ring
+ * @return number of wrong results
+ */
+template<typename R>
+int checkMerge() {
+    mt19937 random(7);
+    const size_t sizes[] = {0, 1, 5, 40, 300};
+    int wrong = 0;
+    for (size_t first : sizes) {
+        for (size_t second : sizes) {
+            for (int layout = 0; layout < 3; layout++) {
+                vector<Pair> mine = randomPairs(random, first, 10, 0);
+                vector<Pair> theirs = randomPairs(random, second, 10, 1000);
+                stable_sort(mine.begin(), mine.end(), keyLess);
+                stable_sort(theirs.begin(), theirs.end(), keyLess);
+                R ring = makeRing<R>(mine, layout), other = makeRing<R>(theirs, 2 - layout);
+                ring.merge(other);
+                vector<Pair> expected = mine;
+                expected.insert(expected.end(), theirs.begin(), theirs.end());
+                stable_sort(expected.begin(), expected.end(), keyLess);
+                wrong += elements(ring) != expected || other.size() != 0;
+            }
+        }
+    }
+    return wrong;
+}
+
+/**
+ * Sort and merge of linked and array rings are stable and give sorted rings
+ */
+void testSortAndMerge() {
+    CHECK(checkSort<LinkedRing>() == 0);
+    CHECK(checkSort<ArrayRing>() == 0);
+    CHECK(checkMerge<LinkedRing>() == 0);
+    CHECK(checkMerge<ArrayRing>() == 0);
+}
+
+/**
+ * Iterator taken before sorting or merging a reversed linked ring still points to its element and walks
+ * the ring in its new order
+ */
+void testIteratorsOfReversedRing() {
+    mt19937 random(3);
+    vector<Pair> pairs = randomPairs(random, 100, 20, 0);
+    LinkedRing ring = makeRing<LinkedRing>(pairs, 1);
+    auto it = ring.begin();
+    for (int i = 0; i < 10; i++) ++it;
+    Pair pointed(it->key, it->info);
+    ring.sort();
+    stable_sort(pairs.begin(), pairs.end(), keyLess);
+    size_t position = find(pairs.begin(), pairs.end(), pointed) - pairs.begin();
+    int wrong = 0;
+    for (size_t i = 0; i < pairs.size(); i++, ++it)
+        wrong += Pair(it->key, it->info) != pairs[(position + i) % pairs.size()];
+    CHECK(wrong == 0);
+    vector<Pair> theirs = randomPairs(random, 50, 20, 1000);
+    stable_sort(theirs.begin(), theirs.end(), keyLess);
+    LinkedRing other = makeRing<LinkedRing>(theirs, 1);
+    auto last = ring.constLast();
+    ring.merge(other);
+    CHECK(ring.isReversed());
+    pairs.insert(pairs.end(), theirs.begin(), theirs.end());
+    stable_sort(pairs.begin(), pairs.end(), keyLess);
+    position = find(pairs.begin(), pairs.end(), Pair(last->key, last->info)) - pairs.begin();
+    wrong = 0;
+    for (size_t i = 0; i < pairs.size(); i++, --last)
+        wrong += Pair(last->key, last->info) != pairs[(position + pairs.size() - i) % pairs.size()];
+    CHECK(wrong == 0);
+}
+
+int main() {
+    testSortAndMerge();
+    testIteratorsOfReversedRing();
+    return finish();
+}
@@ -0,0 +1,162 @@
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Check.cpp"
+#include "SequenceLoader.cpp"
+
+typedef pair<string, string> Line;
+
+/**
+ * Writes text to a file
+ * @param path path of the file
+ * @param text text
+ */
+void writeFile(const string &path, const string &text) {
+    FILE *file = fopen(path.c_str(), "wb");
+    CHECK(file != nullptr);
+    if (!file) return;
+    CHECK(fwrite(text.data(), 1, text.size(), file) == text.size());
+    fclose(file);
+}
+
+/**
+ * Parses whole text with parseLines
+ * @param text text
+ * @param delimiter character between key and info
+ * @return key and info of every line
+ */
+vector<Line> parse(const string &text, char delimiter = '\t') {
+    vector<Line> lines;
+    auto visit = [&](const TextSlice &key, const TextSlice &info) { lines.emplace_back(key.str(), info.str()); };
+    parseLines(text.data(), text.data() + text.size(), delimiter, visit, true);
+    return lines;
+}
+
+/**
+ * Reads file with streamFile
+ * @param path path of the file
+ * @param window number of bytes mapped at a time
+ * @return key and info of every line
+ */
+vector<Line> stream(const string &path, size_t window) {
+    vector<Line> lines;
+    size_t visited = streamFile(path, [&](const TextSlice &key, const TextSlice &info) {
+        lines.emplace_back(key.str(), info.str());
+    }, '\t', window);
+    CHECK(visited == lines.size());
+    return lines;
+}
+
+/**
+ * \r before newline is not part of info, empty lines are skipped, last line may have no newline and
+ * info may contain the delimiter
+ */
+void testLines() {
+    vector<Line> expected = {{"a", "1"}, {"b", ""}, {"c", "x\ty"}, {"d", "4"}};
+    CHECK(parse("a\t1\r\n\r\nb\t\n\nc\tx\ty\r\nd\t4") == expected);
+    CHECK(parse("a\t1\nb\t\n\n\nc\tx\ty\nd\t4\n") == expected);
+    CHECK(parse("a;1\nb;2\n", ';') == vector<Line>({{"a", "1"}, {"b", "2"}}));
+    CHECK(parse("").empty() && parse("\n\r\n\n").empty());
+}
+
+/**
+ * Line without delimiter is rejected, also when it is the last one
+ */
+void testLineWithoutDelimiter() {
+    CHECK_THROWS(parse("a\t1\nbroken\nc\t3\n"), invalid_argument);
+    CHECK_THROWS(parse("a\t1\nbroken"), invalid_argument);
+    CHECK_THROWS(parse("a\t1\nbroken\r\n"), invalid_argument);
+}
+
+/**
+ * Keys are converted only if the whole text is a number of the key type
+ */
+void testParseKey() {
+    int value = 0;
+    parseKey(TextSlice("-42", 3), value);
+    CHECK(value == -42);
+    CHECK_THROWS(parseKey(TextSlice(" 42", 3), value), invalid_argument);
+    CHECK_THROWS(parseKey(TextSlice("+42", 3), value), invalid_argument);
+    CHECK_THROWS(parseKey(TextSlice("42 ", 3), value), invalid_argument);
+    CHECK_THROWS(parseKey(TextSlice("", 0), value), invalid_argument);
+    CHECK_THROWS(parseKey(TextSlice("4294967296", 10), value), invalid_argument);
+    unsigned short small = 0;
+    parseKey(TextSlice("65535", 5), small);
+    CHECK(small == 65535);
+    CHECK_THROWS(parseKey(TextSlice("65536", 5), small), invalid_argument);
+    CHECK_THROWS(parseKey(TextSlice("-1", 2), small), invalid_argument);
+    uint64_t big = 0;
+    parseKey(TextSlice("18446744073709551615", 20), big);
+    CHECK(big == UINT64_MAX);
+    CHECK_THROWS(parseKey(TextSlice("-0", 2), big), invalid_argument);
+    float number = 0;
+    parseKey(TextSlice("-1.5e3", 6), number);
+    CHECK(number == -1500.0f);
+    CHECK_THROWS(parseKey(TextSlice("1e39", 4), number), invalid_argument);
+    CHECK_THROWS(parseKey(TextSlice("+1.5", 4), number), invalid_argument);
+    CHECK_THROWS(parseKey(TextSlice("1.5x", 4), number), invalid_argument);
+    parseKey(TextSlice("inf", 3), number);
+    CHECK(number > 1e38f);
+    double precise = 0;
+    parseKey(TextSlice("1e300", 5), precise);
+    CHECK(precise == 1e300);
+}
+
+/**
+ * Loaded sequence has converted keys and infos pointing into the mapped file
+ */
+void testLoadSequence() {
+    TemporaryDirectory directory;
+    string path = directory.file("numbers");
+    writeFile(path, "3\tthree\r\n1\tone\n\n2\ttwo");
+    MappedFile file(path);
+    Sequence<int, TextSlice> sequence;
+    CHECK(loadSequence(file, sequence) == 3);
+    CHECK(sequence.getInfo(1).str() == "one" && sequence.getInfo(3).str() == "three");
+    CHECK(sequence.getInfo(2).str() == "two");
+    const char *text = file.text().data();
+    CHECK(sequence.getInfo(1).data() >= text && sequence.getInfo(1).data() < text + file.size());
+    writeFile(path, "1\tone\n+2\ttwo\n");
+    MappedFile invalid(path);
+    Sequence<int, TextSlice> rejected;
+    CHECK_THROWS(loadSequence(invalid, rejected), invalid_argument);
+}
+
+/**
+ * Streaming with windows smaller than the file gives the same lines as parsing it whole, lines cut by
+ * the end of a window are read again from the next one and lines longer than a window make it grow
+ */
+void testStreamFile() {
+    TemporaryDirectory directory;
+    string path = directory.file("lines");
+    string text;
+    for (int i = 0; i < 3000; i++) {
+        text += "key" + to_string(i) + "\t" + string((size_t) (i * 37 % 200), 'v');
+        text += i % 5 == 0 ? "\r\n" : "\n";
+        if (i % 97 == 0) text += "\n";
+        if (i == 1500) text += "long\t" + string(50000, 'l') + "\n";
+    }
+    writeFile(path, text);
+    vector<Line> expected = parse(text);
+    CHECK(expected.size() == 3001);
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    CHECK(stream(path, page) == expected);
+    CHECK(stream(path, 3 * page) == expected);
+    CHECK(stream(path, 1) == expected);
+    CHECK(stream(path, 64 << 20) == expected);
+    writeFile(path, "");
+    CHECK(stream(path, page).empty());
+    writeFile(path, "a\t1\n" + string(3 * page, 'x') + "\n");
+    CHECK_THROWS(stream(path, page), invalid_argument);
+}
+
+int main() {
+    testLines();
+    testLineWithoutDelimiter();
+    testParseKey();
+    testLoadSequence();
+    testStreamFile();
+    return finish();
+}
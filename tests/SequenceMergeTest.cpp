@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Check.cpp"
+#include "Sequence.cpp"
+
+typedef pair<int, int> Pair;
+
+/**
+ * Creates sorted sequence of given pairs, adding them in order of keys
+ * @param pairs key and info of elements, sorted in place
+ * @return sequence
+ */
+Sequence<int, int> sortedSequence(vector<Pair> &pairs) {
+    stable_sort(pairs.begin(), pairs.end(), [](const Pair &a, const Pair &b) { return a.first < b.first; });
+    Sequence<int, int> sequence;
+    for (const Pair &element : pairs) sequence.addElement(element.first, element.second);
+    return sequence;
+}
+
+/**
+ * Returns keys and infos of the sequence
+ * @param sequence sequence
+ * @return key and info of every element
+ */
+vector<Pair> pairs(const Sequence<int, int> &sequence) {
+    vector<Pair> result;
+    const MyRing<int, int> &list = sequence.getList();
+    for (size_t i = 0; i < list.size(); i++) result.emplace_back(list[i].key, list[i].info);
+    return result;
+}
+
+/**
+ * Merges random sorted sequences and compares the result with stable sort of both of them, elements
+ * of the first sequence before the second. Infos are unique, so order of equal keys is checked too.
+ * @param random generator
+ * @param first number of elements of the first sequence
+ * @param second number of elements of the second sequence
+ * @param firstKeys keys of the first sequence are in [0, firstKeys)
+ * @param offset keys of the second sequence are in [offset, offset + secondKeys)
+ * @param secondKeys number of different keys of the second sequence
+ */
+void checkMerge(mt19937 &random, int first, int second, int firstKeys, int offset, int secondKeys) {
+    vector<Pair> mine, theirs;
+    for (int i = 0; i < first; i++) mine.emplace_back((int) (random() % firstKeys), i);
+    for (int i = 0; i < second; i++) theirs.emplace_back(offset + (int) (random() % secondKeys), first + i);
+    Sequence<int, int> a = sortedSequence(mine), b = sortedSequence(theirs);
+    vector<Pair> expected = mine;
+    expected.insert(expected.end(), theirs.begin(), theirs.end());
+    stable_sort(expected.begin(), expected.end(), [](const Pair &x, const Pair &y) { return x.first < y.first; });
+    Sequence<int, int> merged = a.merge(b);
+    CHECK(pairs(merged) == expected);
+    CHECK(merged.isSorted());
+    CHECK(pairs(a) == mine && pairs(b) == theirs);
+    if (!expected.empty()) CHECK(merged.getInfo(expected.front().first) == expected.front().second);
+}
+
+/**
+ * Random sequences of many sizes, with many equal keys, interleaving or not
+ */
+void testRandomMerges() {
+    mt19937 random(2018);
+    const int sizes[] = {0, 1, 2, 7, 64, 300};
+    for (int first : sizes) {
+        for (int second : sizes) {
+            checkMerge(random, first, second, 5, 0, 5);
+            checkMerge(random, first, second, 1000, 0, 1000);
+            checkMerge(random, first, second, 50, 25, 50);
+            checkMerge(random, first, second, 100, 100, 100);
+            checkMerge(random, first, second, 100, -100, 100);
+        }
+    }
+}
+
+/**
+ * Merged sequence finds the first of equal keys, which comes from the first sequence
+ */
+void testEqualKeys() {
+    Sequence<string, int> a, b;
+    for (int i = 0; i < 10; i++) a.addElement("key", i);
+    for (int i = 0; i < 10; i++) b.addElement("key", 100 + i);
+    b.addElement("later", 200);
+    Sequence<string, int> merged = b.merge(a);
+    CHECK(merged.getInfo("key") == 100);
+    CHECK(merged.getElement(10).getInfo() == 0);
+    CHECK(merged.getElement(20).getKey() == "later");
+}
+
+/**
+ * Merging with an unsorted sequence throws, on either side
+ */
+void testUnsorted() {
+    Sequence<int, int> sorted, unsorted;
+    for (int i = 0; i < 5; i++) sorted.addElement(i, i);
+    unsorted.addElement(2, 0);
+    unsorted.addElement(1, 0);
+    CHECK(!unsorted.isSorted());
+    CHECK_THROWS(sorted.merge(unsorted), invalid_argument);
+    CHECK_THROWS(unsorted.merge(sorted), invalid_argument);
+}
+
+/**
+ * Elements added or changed through list, not addElement, are checked for order before the next lookup
+ */
+void testDirectListChanges() {
+    Sequence<int, int> appended;
+    appended.list.push_back(5, 50);
+    appended.list.push_back(1, 10);
+    CHECK(!appended.isSorted());
+    CHECK(appended.getInfo(1) == 10 && appended.getInfo(5) == 50);
+    Sequence<int, int> ordered;
+    for (int i = 0; i < 100; i++) ordered.addElement(i, i * 10);
+    ordered.list.push_back(100, 1000);
+    CHECK(ordered.isSorted() && ordered.getInfo(100) == 1000);
+    ordered.list.at(10).key = 1000;
+    CHECK(!ordered.isSorted());
+    CHECK(ordered.getInfo(1000) == 100 && ordered.getInfo(50) == 500);
+    CHECK_THROWS(ordered.merge(appended), invalid_argument);
+    ordered.list.clear();
+    for (int i = 0; i < 10; i++) ordered.list.push_back(i, i);
+    CHECK(ordered.isSorted() && ordered.getInfo(7) == 7);
+    Sequence<int, int> assigned;
+    assigned = appended;
+    CHECK(!assigned.isSorted() && assigned.getInfo(1) == 10);
+}
+
+int main() {
+    testRandomMerges();
+    testEqualKeys();
+    testUnsorted();
+    testDirectListChanges();
+    return finish();
+}
@@ -0,0 +1,64 @@
+#include <string>
+#include "Check.cpp"
+#include "AVLTree.cpp"
+#include "StringPool.cpp"
+
+/**
+ * Reverse lookup finds key of every interned value, whatever order of texts and keys is
+ */
+void testReverseLookup() {
+    const string plants[] = {"oak", "birch", "willow", "alder", "maple", "ash", "yew"};
+    const int COUNT = 7;
+    StringPool pool;
+    AVLTree<int, InternedString> tree;
+    for (int i = 0; i < COUNT; i++) tree.insert(i, pool.intern(plants[i]));
+    for (int i = 0; i < COUNT; i++) {
+        CHECK(tree.searchValue(pool.intern(plants[i])) != nullptr);
+        CHECK(tree(pool.intern(plants[i])) == i);
+        CHECK(tree(pool.find(plants[i])) == i);
+    }
+    CHECK(tree.searchValue(pool.find("elm")) == nullptr);
+    CHECK_THROWS(tree(pool.intern("elm")), invalid_argument);
+}
+
+/**
+ * Reverse lookup in a larger tree finds every value, also after removals rebalanced it
+ */
+void testReverseLookupAfterRemovals() {
+    const int COUNT = 500;
+    StringPool pool;
+    AVLTree<int, InternedString> tree;
+    for (int i = 0; i < COUNT; i++) tree.insert(i, pool.intern(to_string((i * 7919) % COUNT)));
+    for (int i = 0; i < COUNT; i += 3) tree.remove(i);
+    int wrong = 0;
+    for (int i = 0; i < COUNT; i++) {
+        InternedString value = pool.find(to_string((i * 7919) % COUNT));
+        bool found = tree.searchValue(value) != nullptr;
+        if (found != (i % 3 != 0) || (found && tree(value) != i)) wrong++;
+    }
+    CHECK(wrong == 0);
+}
+
+/**
+ * Every text is kept once and removed from the pool with its last handle
+ */
+void testReferences() {
+    StringPool pool;
+    {
+        InternedString first = pool.intern("rose"), second = pool.intern("rose");
+        CHECK(first == second && pool.size() == 1 && first.references() == 2);
+        InternedString other = pool.intern("tulip");
+        CHECK(first != other && pool.size() == 2);
+        other = first;
+        CHECK(pool.size() == 1 && first.references() == 3);
+        CHECK(pool.find("lily") == InternedString() && pool.size() == 1);
+    }
+    CHECK(pool.size() == 0);
+}
+
+int main() {
+    testReverseLookup();
+    testReverseLookupAfterRemovals();
+    testReferences();
+    return finish();
+}
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <deque>
+#include <random>
+#include "Check.cpp"
+#include "WindowRing.cpp"
+
+/**
+ * Compares window with the last elements pushed, kept in a deque
+ * @param window window
+ * @param last keys of elements in the window, infos are keys * 3 % 101 - 50
+ * @return true if size, elements, sum, minimum and maximum agree
+ */
+bool agrees(const WindowRing<int, long> &window, const deque<int> &last) {
+    if (window.size() != last.size()) return false;
+    long sum = 0, low = 0, high = 0;
+    for (size_t i = 0; i < last.size(); i++) {
+        long info = last[i] * 3L % 101 - 50;
+        if (window.getKey(i) != last[i] || window.getInfo(i) != info) return false;
+        sum += info;
+        low = i == 0 ? info : std::min(low, info);
+        high = i == 0 ? info : std::max(high, info);
+    }
+    if (window.sum() != sum) return false;
+    return last.empty() || (window.min() == low && window.max() == high);
+}
+
+/**
+ * Minimum, maximum and sum stay right while old elements are overwritten, for windows of many capacities
+ * and for infos that repeat, rise and fall
+ */
+void testOverwrite() {
+    const size_t capacities[] = {1, 2, 3, 8, 50};
+    int wrong = 0;
+    for (size_t capacity : capacities) {
+        WindowRing<int, long> window(capacity);
+        deque<int> last;
+        for (int i = 0; i < 2000; i++) {
+            int key = i < 500 ? i : i < 1000 ? 1000 - i : i % 7;
+            window.push(key, key * 3L % 101 - 50);
+            last.push_back(key);
+            if (last.size() > capacity) last.pop_front();
+            wrong += !agrees(window, last);
+            wrong += window.isFull() != (last.size() == capacity);
+        }
+    }
+    CHECK(wrong == 0);
+}
+
+/**
+ * Random pushes with clears, copies and assignments keep the window equal to the last pushed elements
+ */
+void testRandomPushes() {
+    mt19937 random(36);
+    WindowRing<int, long> window(20), other(3);
+    deque<int> last;
+    int wrong = 0;
+    for (int i = 0; i < 5000; i++) {
+        int key = (int) (random() % 1000);
+        window.push(key, key * 3L % 101 - 50);
+        last.push_back(key);
+        if (last.size() > 20) last.pop_front();
+        if (i % 777 == 0) {
+            WindowRing<int, long> copy(window);
+            wrong += !agrees(copy, last);
+            other = window;
+            wrong += !agrees(other, last) || other.capacity() != 20;
+        }
+        if (i % 1999 == 0) {
+            window.clear();
+            last.clear();
+        }
+        wrong += !agrees(window, last);
+    }
+    CHECK(wrong == 0);
+}
+
+/**
+ * Empty window has no minimum, maximum or mean
+ */
+void testEmpty() {
+    WindowRing<int, double> window(4);
+    CHECK(window.isEmpty() && window.sum() == 0.0);
+    CHECK_THROWS(window.min(), runtime_error);
+    CHECK_THROWS(window.max(), runtime_error);
+    CHECK_THROWS(window.mean(), runtime_error);
+    window.push(1, 2.5);
+    window.push(2, 3.5);
+    CHECK(window.mean() == 3.0 && window.min() == 2.5 && window.max() == 3.5);
+    window.clear();
+    CHECK_THROWS(window.min(), runtime_error);
+}
+
+int main() {
+    testOverwrite();
+    testRandomPushes();
+    testEmpty();
+    return finish();
+}